@@ -7,6 +7,17 @@ Dependencies:
 / bs842_text: https://github.com/bSalmon842/bs842_tools/blob/master/bs842_text.h
 // stb_truetype: https://github.com/nothings/stb/blob/master/stb_truetype.h
 / bs842_2dprim: https://github.com/bSalmon842/bs842_tools/blob/master/bs842_2dprim.h
+/ stb_image (only with BS842_IMGUI_IMAGES): https://github.com/nothings/stb/blob/master/stb_image.h
+*/
+
+/* USAGE
+Optional Defines:
+These defines should be placed before the include
+- #define BS842_IMGUI_PROFILE to time every widget call and frame and count the allocations the imgui makes, read back
+with BS842_Imgui_GetProfile
+- #define BS842_IMGUI_IMAGES for BS842_Image and its decoded image cache, needs stb_image.h
+
+The headless benchmark is bs842_imgui_bench.cpp, build and usage are at the top of that file
 */
 
 #ifndef BS842_IMGUI_H
@@ -14,11 +25,41 @@ Dependencies:
 #include "bs842_text.h"
 #include "bs842_2dprim.h"
 
+#ifdef BS842_IMGUI_IMAGES
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+#endif
+
 //// INTERNAL ////
 #ifndef MAX_PATH
 #define MAX_PATH 260
 #endif
 
+#ifdef _WIN32
+#define BSINTERNAL_PATH_SEPARATOR '\\'
+#define BSINTERNAL_PATH_SEPARATOR_STRING "\\"
+#else
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#define BSINTERNAL_LINUX 1
+#endif
+#define BSINTERNAL_PATH_SEPARATOR '/'
+#define BSINTERNAL_PATH_SEPARATOR_STRING "/"
+#endif
+
 #define bsint_function static
 #define bsint_global static
 #define bsint_local_persist static
@@ -27,13 +68,129 @@ typedef unsigned __int8 bsint_u8;
 typedef unsigned __int32 bsint_u32;
 typedef __int32 bsint_s32;
 typedef __int32 bsint_b32;
+typedef unsigned long long bsint_u64;
 typedef size_t bsint_mem_index;
 typedef float bsint_f32;
 
-inline void *bs842_internal_CopyMem(void *dest, void *src, bsint_mem_index size)
+// NOTE(bSalmon): Acquire/release for the input queue indices, compiler intrinsics so nothing else has to be included.
+// MSVC only gets hardware ordering from the interlocked functions (plain volatile is relaxed on ARM), so the loads and
+// stores go through them too
+#ifdef _MSC_VER
+#include <intrin.h>
+inline bsint_u32 BSInternal_LoadAcquire(volatile bsint_u32 *value)
+{
+    return (bsint_u32)_InterlockedCompareExchange((volatile long *)value, 0, 0);
+}
+
+inline void BSInternal_StoreRelease(volatile bsint_u32 *value, bsint_u32 newValue)
+{
+    _InterlockedExchange((volatile long *)value, (long)newValue);
+}
+
+inline void BSInternal_AtomicIncrement(volatile bsint_u32 *value)
+{
+    _InterlockedIncrement((volatile long *)value);
+}
+
+inline bsint_u32 BSInternal_AtomicExchange(volatile bsint_u32 *value, bsint_u32 newValue)
+{
+    return (bsint_u32)_InterlockedExchange((volatile long *)value, (long)newValue);
+}
+
+inline bsint_b32 BSInternal_AtomicCompareExchange(volatile bsint_u32 *value, bsint_u32 expected, bsint_u32 newValue)
+{
+    return (_InterlockedCompareExchange((volatile long *)value, (long)newValue, (long)expected) == (long)expected);
+}
+
+// NOTE(bSalmon): Ordered against the interlocked operations around it, for a flag and a counter written on different threads
+inline bsint_u32 BSInternal_LoadFenced(volatile bsint_u32 *value)
+{
+    return (bsint_u32)_InterlockedCompareExchange((volatile long *)value, 0, 0);
+}
+#else
+inline bsint_u32 BSInternal_LoadAcquire(volatile bsint_u32 *value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+inline void BSInternal_StoreRelease(volatile bsint_u32 *value, bsint_u32 newValue)
+{
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+inline void BSInternal_AtomicIncrement(volatile bsint_u32 *value)
+{
+    __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+inline bsint_u32 BSInternal_AtomicExchange(volatile bsint_u32 *value, bsint_u32 newValue)
+{
+    return __atomic_exchange_n(value, newValue, __ATOMIC_SEQ_CST);
+}
+
+inline bsint_b32 BSInternal_AtomicCompareExchange(volatile bsint_u32 *value, bsint_u32 expected, bsint_u32 newValue)
+{
+    return __atomic_compare_exchange_n(value, &expected, newValue, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+// NOTE(bSalmon): Ordered against the interlocked operations around it, for a flag and a counter written on different threads
+inline bsint_u32 BSInternal_LoadFenced(volatile bsint_u32 *value)
+{
+    return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+#endif
+
+// NOTE(bSalmon): Nanoseconds from a monotonic clock
+inline bsint_u64 BSInternal_GetTimestampNs()
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+    LARGE_INTEGER frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    bsint_u64 seconds = (bsint_u64)(counter.QuadPart / frequency.QuadPart);
+    bsint_u64 remainder = (bsint_u64)(counter.QuadPart % frequency.QuadPart);
+    return (seconds * 1000000000) + ((remainder * 1000000000) / (bsint_u64)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((bsint_u64)now.tv_sec * 1000000000) + (bsint_u64)now.tv_nsec;
+#endif
+}
+
+// NOTE(bSalmon): Microseconds from a monotonic clock
+inline bsint_u64 BSInternal_GetTimestamp()
+{
+    return BSInternal_GetTimestampNs() / 1000;
+}
+
+// NOTE(bSalmon): Every allocation the imgui makes goes through these so profiling can count them. The count is shared
+// by every context and the browser's worker thread
+#ifdef BS842_IMGUI_PROFILE
+bsint_global volatile bsint_u32 bs842_internal_allocationCount;
+
+inline void *BSInternal_CountAllocation(void *memory)
+{
+    if (memory)
+    {
+        BSInternal_AtomicIncrement(&bs842_internal_allocationCount);
+    }
+    return memory;
+}
+
+#define BSINTERNAL_MALLOC(size) BSInternal_CountAllocation(malloc(size))
+#define BSINTERNAL_CALLOC(count, size) BSInternal_CountAllocation(calloc(count, size))
+#define BSINTERNAL_REALLOC(memory, size) BSInternal_CountAllocation(realloc(memory, size))
+#else
+#define BSINTERNAL_MALLOC(size) malloc(size)
+#define BSINTERNAL_CALLOC(count, size) calloc(count, size)
+#define BSINTERNAL_REALLOC(memory, size) realloc(memory, size)
+#endif
+
+inline void *bs842_internal_CopyMem(void *dest, const void *src, bsint_mem_index size)
 {
     bsint_u8 *destP = (bsint_u8  *)dest;
-    bsint_u8 *srcP = (bsint_u8  *)src;
+    const bsint_u8 *srcP = (const bsint_u8  *)src;
     
     while (size--)
     {
@@ -60,7 +217,7 @@ inline void bs842_internal_ConcatenateStrings(bsint_mem_index sourceACount, char
 	*dest++ = 0;
 }
 
-inline bsint_s32 bs842_internal_StringLength(char *string)
+inline bsint_s32 bs842_internal_StringLength(const char *string)
 {
 	bsint_s32 result = 0;
 	while (*string++)
@@ -101,44 +258,174 @@ inline bsint_b32 bs842_internal_StringCompare(char *str1, char *str2)
     return result;
 }
 
-struct BSInternal_StringNode
+// NOTE(bSalmon): Per-frame arena, everything pushed is released in BS842_ImguiEnd. Pushes that don't fit go to overflow blocks
+// and the arena regrows to cover them at the next reset, so steady state frames make no heap calls
+#define BSINTERNAL_FRAME_ARENA_DEFAULT_SIZE (256 * 1024)
+
+struct BSInternal_ArenaOverflow
 {
-    char *string;
-    bsint_s32 strLength;
+    BSInternal_ArenaOverflow *next;
+};
+
+struct BSInternal_MemoryArena
+{
+    bsint_u8 *base;
+    bsint_mem_index size;
+    bsint_mem_index used;
     
-    BSInternal_StringNode *next;
-    BSInternal_StringNode *prev;
+    BSInternal_ArenaOverflow *overflow;
+    bsint_mem_index overflowSize;
 };
 
-bsint_function BSInternal_StringNode *AddStringNode(BSInternal_StringNode *stringSentinel, bsint_s32 stringSize)
+struct BSInternal_TempMemory
 {
-     BSInternal_StringNode *stringNode = (BSInternal_StringNode *)malloc(sizeof(BSInternal_StringNode));
+    BSInternal_MemoryArena *arena;
+    bsint_mem_index used;
+    BSInternal_ArenaOverflow *overflow;
+};
+
+bsint_function void *BSInternal_PushSize(BSInternal_MemoryArena *arena, bsint_mem_index size)
+{
+    void *result = 0;
     
-    stringNode->string = (char *)malloc(stringSize);
-    stringNode->strLength = stringSize;
+    size = (size + 7) & ~(bsint_mem_index)7;
+    if (!arena->base)
+    {
+        arena->size = (size > BSINTERNAL_FRAME_ARENA_DEFAULT_SIZE) ? size : BSINTERNAL_FRAME_ARENA_DEFAULT_SIZE;
+        arena->base = (bsint_u8 *)BSINTERNAL_MALLOC(arena->size);
+        arena->used = 0;
+    }
     
-    stringNode->prev = stringSentinel;
-    stringNode->next = stringSentinel->next;
+    if ((arena->used + size) <= arena->size)
+    {
+        result = arena->base + arena->used;
+        arena->used += size;
+    }
+    else
+    {
+        BSInternal_ArenaOverflow *overflow = (BSInternal_ArenaOverflow *)BSINTERNAL_MALLOC(sizeof(BSInternal_ArenaOverflow) + size);
+        overflow->next = arena->overflow;
+        arena->overflow = overflow;
+        arena->overflowSize += size;
+        
+        result = overflow + 1;
+    }
     
-    stringNode->prev->next = stringNode;
-    stringNode->next->prev = stringNode;
+    return result;
+}
+#define BSInternal_PushArray(arena, count, type) (type *)BSInternal_PushSize(arena, (count) * sizeof(type))
+
+inline BSInternal_TempMemory BSInternal_BeginTempMemory(BSInternal_MemoryArena *arena)
+{
+    BSInternal_TempMemory result = {};
     
-    return stringNode;
+    result.arena = arena;
+    result.used = arena->used;
+    result.overflow = arena->overflow;
+    
+    return result;
 }
 
-bsint_function void RemoveStringNode(BSInternal_StringNode *removed)
+inline void BSInternal_EndTempMemory(BSInternal_TempMemory temp)
 {
-    free(removed->string);
+    BSInternal_MemoryArena *arena = temp.arena;
+    while (arena->overflow != temp.overflow)
+    {
+        BSInternal_ArenaOverflow *next = arena->overflow->next;
+        free(arena->overflow);
+        arena->overflow = next;
+    }
     
-    removed->prev->next = removed->next;
-    removed->next->prev = removed->prev;
+    arena->used = temp.used;
+}
+
+bsint_function void BSInternal_ResetArena(BSInternal_MemoryArena *arena)
+{
+    while (arena->overflow)
+    {
+        BSInternal_ArenaOverflow *next = arena->overflow->next;
+        free(arena->overflow);
+        arena->overflow = next;
+    }
     
-    removed->next = 0;
-    removed->prev = 0;
+    if (arena->overflowSize)
+    {
+        free(arena->base);
+        arena->size = arena->size + arena->overflowSize + (arena->overflowSize / 2);
+        arena->base = (bsint_u8 *)BSINTERNAL_MALLOC(arena->size);
+        arena->overflowSize = 0;
+    }
+    
+    arena->used = 0;
+}
+
+// NOTE(bSalmon): Fixed size node pool, nodes are carved out of blocks that live until shutdown and recycled through a free list
+#define BSINTERNAL_POOL_NODES_PER_BLOCK 128
+
+struct BSInternal_PoolNode
+{
+    BSInternal_PoolNode *next;
+};
+
+struct BSInternal_NodePool
+{
+    BSInternal_PoolNode *freeList;
+    BSInternal_PoolNode *blocks;
+};
+
+bsint_function void *BSInternal_PoolAlloc(BSInternal_NodePool *pool, bsint_mem_index nodeSize)
+{
+    nodeSize = (nodeSize < sizeof(BSInternal_PoolNode)) ? sizeof(BSInternal_PoolNode) : nodeSize;
+    
+    if (!pool->freeList)
+    {
+        BSInternal_PoolNode *block = (BSInternal_PoolNode *)BSINTERNAL_MALLOC(sizeof(BSInternal_PoolNode) + (nodeSize * BSINTERNAL_POOL_NODES_PER_BLOCK));
+        block->next = pool->blocks;
+        pool->blocks = block;
+        
+        bsint_u8 *nodeMem = (bsint_u8 *)(block + 1);
+        for (bsint_s32 i = 0; i < BSINTERNAL_POOL_NODES_PER_BLOCK; ++i)
+        {
+            BSInternal_PoolNode *node = (BSInternal_PoolNode *)(nodeMem + (i * nodeSize));
+            node->next = pool->freeList;
+            pool->freeList = node;
+        }
+    }
+    
+    BSInternal_PoolNode *result = pool->freeList;
+    pool->freeList = result->next;
+    
+    return result;
+}
+
+inline void BSInternal_PoolFree(BSInternal_NodePool *pool, void *node)
+{
+    BSInternal_PoolNode *freed = (BSInternal_PoolNode *)node;
+    freed->next = pool->freeList;
+    pool->freeList = freed;
+}
+
+bsint_function void BSInternal_PoolRelease(BSInternal_NodePool *pool)
+{
+    while (pool->blocks)
+    {
+        BSInternal_PoolNode *next = pool->blocks->next;
+        free(pool->blocks);
+        pool->blocks = next;
+    }
     
-    free(removed);
+    pool->freeList = 0;
 }
 
+struct BSInternal_StringNode
+{
+    char *string;
+    bsint_s32 strLength;
+    
+    BSInternal_StringNode *next;
+    BSInternal_StringNode *prev;
+};
+
 struct BSInternal_Theme
 {
     bsint_u32 elemOutline;
@@ -177,523 +464,4360 @@ inline bsint_b32 BSInternal_CheckBackBuffer(BSInternal_BackBuffer *backBuffer)
     return result;
 }
 
-struct BSInternal_ImguiInfo
+// NOTE(bSalmon): Widgets record draw commands into segments instead of drawing directly, a segment being the commands issued
+// by one widget between any nested widgets. BS842_ImguiEnd hashes each segment and, in retained mode, only rasterises the
+// segments that changed since last frame along with anything they overlap
+enum BSInternal_DrawCommandType
 {
-    stbtt_fontinfo fontInfo;
-    stbtt_fontinfo fileFontInfo;
-    BSInternal_BackBuffer *backBuffer;
-    BSInternal_Theme theme;
-    
-    bsint_b32 clicked;
-    bsint_b32 dblClicked;
-    bsint_b32 scrolledUp;
-    bsint_b32 scrolledDown;
-    bsint_s32 mouseX;
-    bsint_s32 mouseY;
+    DrawCommand_SolidBox,
+    DrawCommand_HollowBox,
+    DrawCommand_OutlinedBox,
+    DrawCommand_Line,
+    DrawCommand_Text,
+    DrawCommand_Panel,
+    DrawCommand_Image,
+};
+
+// NOTE(bSalmon): A window's chrome rasterised once and kept as runs of the pixels it covers, pixels holds every run
+// back to back. key is everything the chrome's look depends on, a different key captures it again
+struct BSInternal_PanelRun
+{
+    bsint_s32 x;
+    bsint_s32 y;
+    bsint_s32 length;
+    bsint_s32 offset;
+};
+
+struct BSInternal_PanelCache
+{
+    bsint_u32 key;
+    bsint_b32 uncacheable;
+    BSInternal_SizeSpec bounds;
     
-    bsint_s32 currentID;
+    BSInternal_PanelRun *runs;
+    bsint_s32 runCount;
+    bsint_u32 *pixels;
 };
-bsint_global BSInternal_ImguiInfo bs842_internal_info;
 
-enum BS842_Themes
+#ifdef BS842_IMGUI_IMAGES
+enum BSInternal_ImageStatus
 {
-    Theme_Light,
-    Theme_Dark,
-    Theme_TTR,
-    Theme_Count,
+    ImageStatus_Pending,
+    ImageStatus_Ready,
+    ImageStatus_Failed,
 };
 
-bsint_function BSInternal_Theme BSInternal_LoadTheme(bsint_s32 theme)
+// NOTE(bSalmon): One image decoded at one size, pixels are premultiplied 0xAARRGGBB. A request size of 0 is the size the
+// file is. While queued the worker owns pixels, width, height and opaque, status is set last with release
+struct BSInternal_ImageEntry
 {
-    BSInternal_Theme result = {};
+    bsint_u32 key;
+    char path[MAX_PATH];
+    bsint_s32 requestWidth;
+    bsint_s32 requestHeight;
     
-    switch (theme)
-    {
-        case Theme_TTR:
-        {
-            result.elemOutline = 0xFFFF0000;
-            result.elemBackground = 0xFF4D4D4D;
-            result.defaultText = 0xFFFFFFFF;
-             result.menuBarBackground = 0xFF181818;
-            result.menuItemBorder = 0xFFF3F3F3;
-            result.menuItemHovered = 0xFFFF0000;
-            result.fileBrowseFolder = 0xFFAAAAAA;
-            result.fileBrowseFile = 0xFFFFFFFF;
-            result.fileBrowseInvert = 0xFF000000;
-            result.fileBrowseSelected = 0xFFFF0000;
-            result.fileBrowseSelectedBar = 0xFFF3F3F3;
-            break;
-        }
-        
-        default:
-        {
-            break;
-        }
-    }
+    volatile bsint_u32 status;
+    bsint_u32 *pixels;
+    bsint_s32 width;
+    bsint_s32 height;
+    bsint_b32 opaque;
+    bsint_b32 counted;
+    bsint_b32 retryScheduled;
+    bsint_s32 retryFrame;
     
-    return result;
-}
-
-#if 1
-#define INTERNAL_ASSERT(expr) if (!(expr)) {*(bsint_s32 *)0 = 0;}
-#else
-#define INTERNAL_ASSERT(expr) 
-#endif
+    bsint_s32 lastUsedFrame;
+    BSInternal_ImageEntry *lruPrev;
+    BSInternal_ImageEntry *lruNext;
+    BSInternal_ImageEntry *hashNext;
+    BSInternal_ImageEntry *jobNext;
+};
 
-//////////////////
+#define BSINTERNAL_IMAGE_BUCKETS 256
+#define BSINTERNAL_IMAGE_DEFAULT_BUDGET (16 * 1024 * 1024)
+#define BSINTERNAL_IMAGE_RETRY_FRAMES 120
 
-enum BS842_InitCodes
+// NOTE(bSalmon): lruSentinel.lruNext is the most recently used. usedBytes only counts decoded images, pending ones
+// haven't been seen as ready yet
+struct BSInternal_ImageCache
 {
-    Init_Null,
-    Init_Success,
-    Init_FontFail, // Error from stbtt_InitFont()
-    Init_InvalidBackBuffer, // BackBuffer does not match BSInternal_BackBuffer, or format contains invalid values
-    Init_InvalidTheme, // Theme S32 does not correspond to a valid theme
+    BSInternal_ImageEntry *buckets[BSINTERNAL_IMAGE_BUCKETS];
+    BSInternal_ImageEntry lruSentinel;
+    bsint_mem_index usedBytes;
+    bsint_mem_index budgetBytes;
+    
+#if defined(BSINTERNAL_LINUX)
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t jobReady;
+    bsint_b32 running;
+    struct BSInternal_ImguiInfo *context;
+    
+    // NOTE(bSalmon): Shared with the worker, only touched with the mutex held
+    bsint_b32 quit;
+    BSInternal_ImageEntry *firstJob;
+    BSInternal_ImageEntry *lastJob;
+#endif
 };
+#endif
 
-bsint_function bsint_s32 BS842_InitImgui(bsint_u8* fontBuffer, bsint_u8* fileFontBuffer, void *backBuffer, bsint_s32 theme)
+struct BSInternal_DrawCommand
 {
-    bsint_s32 result = Init_Null;
+    BSInternal_DrawCommandType type;
+    BSInternal_SizeSpec rect;
+    bsint_f32 lineThickness;
+    bsint_u32 colour1;
+    bsint_u32 colour2;
     
-    if (!stbtt_InitFont(&bs842_internal_info.fontInfo, fontBuffer, 0))
-    {
-        result = Init_FontFail;
-        return result;
-    }
+    stbtt_fontinfo *fontInfo;
+    const char *text;
+    bsint_s32 textLength;
+    bsint_f32 lineHeight;
+    bsint_f32 xPosPercent;
+    bsint_f32 yPosPercent;
     
-    if (!stbtt_InitFont(&bs842_internal_info.fileFontInfo, fileFontBuffer, 0))
-    {
-        result = Init_FontFail;
-        return result;
-    }
+    BSInternal_PanelCache *panel;
+#ifdef BS842_IMGUI_IMAGES
+    BSInternal_ImageEntry *image;
+#endif
     
-     bs842_internal_info.backBuffer = (BSInternal_BackBuffer *)backBuffer;
-    if (!BSInternal_CheckBackBuffer(bs842_internal_info.backBuffer))
-    {
-        result = Init_InvalidBackBuffer;
-        return result;
-    }
+    BSInternal_DrawCommand *next;
+};
+
+struct BSInternal_DrawSegment
+{
+    bsint_u32 hash;
+    BSInternal_SizeSpec bounds;
+    bsint_b32 needsRaster;
     
-    if (!(theme > -1) || !(theme < Theme_Count))
-    {
-        result = Init_InvalidTheme;
-        return result;
-    }
-    bs842_internal_info.theme = BSInternal_LoadTheme(theme);
+    // NOTE(bSalmon): window is an index + 1 into the frame's windows, 0 is outside any window. Outside segments that
+    // come after the first window of the frame are overlay and draw over every window
+    bsint_s32 window;
+    bsint_b32 overlay;
+    
+    BSInternal_DrawCommand *firstCommand;
+    BSInternal_DrawCommand *lastCommand;
+};
+
+struct BSInternal_DrawList
+{
+    BSInternal_DrawSegment *segments;
+    bsint_s32 segmentCount;
+    bsint_s32 segmentCapacity;
+    bsint_b32 segmentOpen;
     
-    bs842_internal_info.clicked = false;
-    bs842_internal_info.mouseX = 0;
-    bs842_internal_info.mouseY = 0;
+    bsint_u32 *prevHashes;
+    BSInternal_SizeSpec *prevBounds;
+    bsint_s32 prevCount;
+    bsint_s32 prevCapacity;
+    bsint_s32 prevWidth;
+    bsint_s32 prevHeight;
     
-    bs842_internal_info.currentID = 1;
+    BSInternal_SizeSpec *dirtyRects;
+    bsint_s32 dirtyCapacity;
     
-    result = Init_Success;
-    return result;
-}
+    bsint_b32 retained;
+    bsint_b32 fullRedraw;
+    bsint_u32 clearColour;
+    bsint_s32 rasterisedCount;
+    bsint_s32 culledCount;
+};
 
-inline void BS842_Imgui_RegisterMouseClick(bsint_b32 down)
-{
-    bs842_internal_info.clicked = down;
-}
+// NOTE(bSalmon): Widget IDs are the hash of the widget's label seeded with the ID of the scope it lives in, state that has to
+// outlive a frame is kept in an open addressed table keyed on those IDs. States that go unused for a while are evicted
+typedef bsint_u32 BS842_ImguiID;
 
-inline void BS842_Imgui_RegisterMouseMove(bsint_s32 mouseX, bsint_s32 mouseY)
-{
-    bs842_internal_info.mouseX = mouseX;
-    bs842_internal_info.mouseY = mouseY;
-}
+#define BSINTERNAL_ROOT_ID 1
+#define BSINTERNAL_ID_STACK_SIZE 32
+#define BSINTERNAL_STATE_EVICT_FRAMES 256
 
-inline void BS842_Imgui_RegisterMouseDoubleClick(bsint_b32 dbl)
+struct BSInternal_WidgetState
 {
-    bs842_internal_info.dblClicked = dbl;
+    BS842_ImguiID id;
+    bsint_b32 initialised;
+    bsint_s32 lastFrameSeen;
+    
+    bsint_s32 scroll;
+    bsint_s32 selected;
+    bsint_s32 zOrder;
+    
+    // NOTE(bSalmon): Widget owned memory, released with freeData when the state is evicted
+    void *data;
+    void (*freeData)(void *data);
+};
+
+// NOTE(bSalmon): States come from a node pool so pointers to them stay valid when the table grows mid frame
+struct BSInternal_WidgetStateSlot
+{
+    BS842_ImguiID id;
+    BSInternal_WidgetState *state;
+};
+
+struct BSInternal_WidgetStateTable
+{
+    BSInternal_WidgetStateSlot *slots;
+    bsint_s32 count;
+    bsint_s32 capacity;
+    
+    BSInternal_NodePool statePool;
+};
+
+// NOTE(bSalmon): Interactive widgets register their rect as they go, BS842_ImguiEnd buckets that frame's rects into
+// a uniform grid and BS842_ImguiBegin looks at the one cell under the mouse to decide the hovered widget up front
+#define BSINTERNAL_HIT_CELL_SIZE 32
+
+// NOTE(bSalmon): layer is 0 for widgets under every window, the window's zOrder inside one and
+// BSINTERNAL_OVERLAY_LAYER for overlay widgets. The highest layer wins, then the last registered
+#define BSINTERNAL_OVERLAY_LAYER 0x7FFFFFFF
+
+struct BSInternal_HitRect
+{
+    BS842_ImguiID id;
+    BS842_ImguiID window;
+    bsint_s32 layer;
+    BSInternal_SizeSpec rect;
+};
+
+struct BSInternal_HitGrid
+{
+    // NOTE(bSalmon): rects fills during the frame, gridRects is last frame's and is what the cells index into
+    BSInternal_HitRect *rects;
+    bsint_s32 rectCount;
+    bsint_s32 rectCapacity;
+    BSInternal_HitRect *gridRects;
+    bsint_s32 gridRectCount;
+    bsint_s32 gridRectCapacity;
+    
+    bsint_s32 cellsX;
+    bsint_s32 cellsY;
+    bsint_s32 *cellStart;
+    bsint_s32 cellStartCapacity;
+    bsint_s32 *cellRects;
+    bsint_s32 cellRectCapacity;
+    
+    BS842_ImguiID hoveredID;
+    BS842_ImguiID hoveredWindowID;
+};
+
+// NOTE(bSalmon): Windows are opaque over their rect (inclusive pixels) and composite in zOrder, a click inside one
+// brings it to the front
+#define BSINTERNAL_MAX_WINDOWS 32
+
+struct BSInternal_Window
+{
+    BS842_ImguiID id;
+    BSInternal_SizeSpec rect;
+    bsint_s32 zOrder;
+};
+
+enum BS842_LayoutDirection
+{
+    LayoutDirection_Row,
+    LayoutDirection_Column,
+};
+
+// NOTE(bSalmon): inputHash chains everything that decided this item's rect (the layout's area and the backbuffer size,
+// then every item request up to and including this one), so a match means rect and cursorAfter can be reused as is
+struct BSInternal_LayoutItem
+{
+    bsint_u32 inputHash;
+    BS842_Prim_SizeSpec rect;
+    bsint_s32 cursorAfter;
+};
+
+struct BSInternal_LayoutCache
+{
+    BSInternal_LayoutItem *items;
+    bsint_s32 itemCount;
+    bsint_s32 itemCapacity;
+};
+
+#define BSINTERNAL_LAYOUT_STACK_SIZE 8
+
+struct BSInternal_Layout
+{
+    BSInternal_LayoutCache *cache;
+    BSInternal_SizeSpec inner;
+    BS842_LayoutDirection direction;
+    bsint_s32 spacing;
+    bsint_s32 cursor;
+    bsint_s32 itemIndex;
+    bsint_u32 runningHash;
+};
+
+#define BSINTERNAL_MAX_CHAR_INPUT 32
+
+enum BS842_ImguiEventType
+{
+    ImguiEvent_MouseMove,
+    ImguiEvent_Click,
+    ImguiEvent_DoubleClick,
+    ImguiEvent_ScrollUp,
+    ImguiEvent_ScrollDown,
+    ImguiEvent_Char,
+};
+
+struct BS842_ImguiEvent
+{
+    BS842_ImguiEventType type;
+    bsint_s32 mouseX;
+    bsint_s32 mouseY;
+    char c;
+    bsint_u64 timestamp;
+};
+
+// NOTE(bSalmon): Multiple producers, single consumer. Any thread (an input thread, or the render thread through the
+// Register functions) pushes, BS842_ImguiBegin drains. A producer claims a slot by moving writeIndex on, then marks it
+// published with its index + 1 once the event is written, and the consumer stops at the first slot that isn't published
+// yet. The indices only ever increase and wrap through the mask
+#define BSINTERNAL_EVENT_QUEUE_SIZE 1024
+
+struct BSInternal_EventQueue
+{
+    BS842_ImguiEvent events[BSINTERNAL_EVENT_QUEUE_SIZE];
+    volatile bsint_u32 published[BSINTERNAL_EVENT_QUEUE_SIZE];
+    volatile bsint_u32 writeIndex;
+    bsint_u8 padding[60];
+    volatile bsint_u32 readIndex;
+};
+
+#define BS842_IMGUI_WAIT_FOREVER 0xFFFFFFFFFFFFFFFFull
+
+// NOTE(bSalmon): sequence goes up on every event and data change notification, from any thread. The render thread only
+// sleeps on it while waiting is set, so notifying costs a syscall only when there's someone to wake
+struct BSInternal_RedrawSignal
+{
+    volatile bsint_u32 sequence;
+    volatile bsint_u32 waiting;
+#ifdef _WIN32
+    HANDLE event;
+#endif
+    
+    // NOTE(bSalmon): Render thread only. deadline is a BSInternal_GetTimestamp time, 0 for none
+    bsint_b32 begun;
+    bsint_u32 frameSequence;
+    bsint_u64 deadline;
+};
+
+#ifdef BS842_IMGUI_PROFILE
+enum BS842_ImguiProfileWidget
+{
+    ProfileWidget_MenuBar,
+    ProfileWidget_MenuBarItem,
+    ProfileWidget_TextBox,
+    ProfileWidget_Window,
+    ProfileWidget_Button,
+    ProfileWidget_Scroll,
+    ProfileWidget_FileBrowser,
+    ProfileWidget_Table,
+    ProfileWidget_Image,
+    
+    ProfileWidget_Count,
+};
+
+#define BS842_IMGUI_PROFILE_FRAMES 1024
+
+// NOTE(bSalmon): One sample per frame for the last BS842_IMGUI_PROFILE_FRAMES frames, frame n is at
+// n % BS842_IMGUI_PROFILE_FRAMES. Widget times include the widgets they call, so a file browser's time has its buttons in it
+struct BS842_ImguiProfile
+{
+    bsint_s32 frameCount;
+    bsint_u32 frameNs[BS842_IMGUI_PROFILE_FRAMES];
+    bsint_u32 rasterNs[BS842_IMGUI_PROFILE_FRAMES];
+    bsint_u32 allocations[BS842_IMGUI_PROFILE_FRAMES];
+    bsint_u32 widgetNs[ProfileWidget_Count][BS842_IMGUI_PROFILE_FRAMES];
+    bsint_u32 widgetCalls[ProfileWidget_Count][BS842_IMGUI_PROFILE_FRAMES];
+    
+    bsint_u64 frameStart;
+    bsint_u32 allocationStart;
+};
+#endif
+
+struct BSInternal_ImguiInfo
+{
+    stbtt_fontinfo fontInfo;
+    stbtt_fontinfo fileFontInfo;
+    BSInternal_BackBuffer *backBuffer;
+    BSInternal_Theme theme;
+    
+    // NOTE(bSalmon): This frame's input, filled from the event queue in BS842_ImguiBegin. Scrolls are tick counts
+    bsint_b32 clicked;
+    bsint_b32 dblClicked;
+    bsint_s32 scrolledUp;
+    bsint_s32 scrolledDown;
+    bsint_s32 mouseX;
+    bsint_s32 mouseY;
+    char charInput[BSINTERNAL_MAX_CHAR_INPUT];
+    bsint_s32 charInputCount;
+    bsint_u64 lastInputTimestamp;
+    
+    BSInternal_EventQueue eventQueue;
+    BSInternal_RedrawSignal redrawSignal;
+    
+    BS842_ImguiID currentID;
+    BS842_ImguiID idStack[BSINTERNAL_ID_STACK_SIZE];
+    bsint_s32 idStackCount;
+    
+    BSInternal_Layout layoutStack[BSINTERNAL_LAYOUT_STACK_SIZE];
+    bsint_s32 layoutStackCount;
+    
+    BSInternal_HitGrid hitGrid;
+    BSInternal_Window windows[BSINTERNAL_MAX_WINDOWS];
+    bsint_s32 windowCount;
+    bsint_s32 currentWindow;
+    bsint_s32 windowTopZ;
+    bsint_b32 panelCaching;
+    
+    BS842_ImguiID hotID;
+    BS842_ImguiID activeID;
+    bsint_b32 clickClaimed;
+    bsint_s32 frameIndex;
+    BSInternal_WidgetStateTable stateTable;
+    
+    BSInternal_MemoryArena frameArena;
+    BSInternal_NodePool stringNodePool;
+    
+    BSInternal_DrawList drawList;
+    BS842_TextBatch textBatch;
+    
+#ifdef BS842_IMGUI_IMAGES
+    BSInternal_ImageCache imageCache;
+#endif
+    
+#ifdef BS842_IMGUI_PROFILE
+    BS842_ImguiProfile profile;
+#endif
+};
+typedef BSInternal_ImguiInfo BS842_ImguiContext;
+
+// NOTE(bSalmon): Everything goes through the calling thread's current context, the default one unless
+// BS842_Imgui_SetContext picked another. Separate contexts share nothing so they can be built and rasterised on
+// different threads at the same time
+bsint_global BS842_ImguiContext bs842_internal_defaultContext;
+bsint_global thread_local BS842_ImguiContext *bs842_internal_context = &bs842_internal_defaultContext;
+#define BSINTERNAL_CTX (*bs842_internal_context)
+
+bsint_function BS842_ImguiContext *BS842_Imgui_CreateContext()
+{
+    BS842_ImguiContext *result = (BS842_ImguiContext *)BSINTERNAL_CALLOC(1, sizeof(BS842_ImguiContext));
+    return result;
+}
+
+// NOTE(bSalmon): Returns the previous context so it can be put back, 0 goes back to the default
+inline BS842_ImguiContext *BS842_Imgui_SetContext(BS842_ImguiContext *context)
+{
+    BS842_ImguiContext *result = bs842_internal_context;
+    bs842_internal_context = (context) ? context : &bs842_internal_defaultContext;
+    return result;
+}
+
+inline BS842_ImguiContext *BS842_Imgui_GetContext()
+{
+    return bs842_internal_context;
+}
+
+inline void BSInternal_WakeContext(BS842_ImguiContext *context)
+{
+    BSInternal_RedrawSignal *signal = &context->redrawSignal;
+    BSInternal_AtomicIncrement(&signal->sequence);
+    if (BSInternal_LoadFenced(&signal->waiting))
+    {
+#ifdef _WIN32
+        SetEvent(signal->event);
+#elif defined(BSINTERNAL_LINUX)
+        syscall(SYS_futex, &signal->sequence, FUTEX_WAKE_PRIVATE, 1, 0, 0, 0);
+#endif
+    }
+}
+
+#ifdef BS842_IMGUI_PROFILE
+#define BSINTERNAL_PROFILE_BEGIN(widget) bsint_u64 bsint_profileStart = BSInternal_GetTimestampNs()
+#define BSINTERNAL_PROFILE_END(widget) BSInternal_AddProfileSample(widget, bsint_profileStart)
+
+inline void BSInternal_AddProfileSample(BS842_ImguiProfileWidget widget, bsint_u64 start)
+{
+    BS842_ImguiProfile *profile = &BSINTERNAL_CTX.profile;
+    bsint_s32 sample = profile->frameCount % BS842_IMGUI_PROFILE_FRAMES;
+    profile->widgetNs[widget][sample] += (bsint_u32)(BSInternal_GetTimestampNs() - start);
+    ++profile->widgetCalls[widget][sample];
+}
+
+inline BS842_ImguiProfile *BS842_Imgui_GetProfile()
+{
+    return &BSINTERNAL_CTX.profile;
+}
+
+inline void BS842_Imgui_ResetProfile()
+{
+    BSINTERNAL_CTX.profile = {};
+}
+
+// NOTE(bSalmon): percentile is 0 to 1, samples is one of the per frame arrays of a profile. Only the frames still held
+// are looked at, the rest of the array is ignored
+bsint_function bsint_u32 BS842_Imgui_ProfilePercentile(BS842_ImguiProfile *profile, bsint_u32 *samples, bsint_f32 percentile)
+{
+    bsint_s32 count = (profile->frameCount < BS842_IMGUI_PROFILE_FRAMES) ? profile->frameCount : BS842_IMGUI_PROFILE_FRAMES;
+    if (!count)
+    {
+        return 0;
+    }
+    
+    bsint_u32 sorted[BS842_IMGUI_PROFILE_FRAMES];
+    for (bsint_s32 index = 0; index < count; ++index)
+    {
+        bsint_u32 value = samples[index];
+        bsint_s32 insert = index;
+        for (; (insert > 0) && (sorted[insert - 1] > value); --insert)
+        {
+            sorted[insert] = sorted[insert - 1];
+        }
+        sorted[insert] = value;
+    }
+    
+    bsint_s32 rank = (bsint_s32)(percentile * (bsint_f32)(count - 1) + 0.5f);
+    rank = (rank < 0) ? 0 : ((rank >= count) ? count - 1 : rank);
+    return sorted[rank];
+}
+#else
+#define BSINTERNAL_PROFILE_BEGIN(widget)
+#define BSINTERNAL_PROFILE_END(widget)
+#endif
+
+bsint_function BSInternal_StringNode *AddStringNode(BSInternal_StringNode *stringSentinel, bsint_s32 stringSize)
+{
+    BSInternal_StringNode *stringNode = (BSInternal_StringNode *)BSInternal_PoolAlloc(&BSINTERNAL_CTX.stringNodePool, sizeof(BSInternal_StringNode));
+    
+    stringNode->string = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, stringSize, char);
+    stringNode->strLength = stringSize;
+    
+    stringNode->prev = stringSentinel;
+    stringNode->next = stringSentinel->next;
+    
+    stringNode->prev->next = stringNode;
+    stringNode->next->prev = stringNode;
+    
+    return stringNode;
+}
+
+// NOTE(bSalmon): The string is owned by the frame arena so only the node goes back to the pool
+bsint_function void RemoveStringNode(BSInternal_StringNode *removed)
+{
+    removed->prev->next = removed->next;
+    removed->next->prev = removed->prev;
+    
+    removed->next = 0;
+    removed->prev = 0;
+    
+    BSInternal_PoolFree(&BSINTERNAL_CTX.stringNodePool, removed);
+}
+
+#define BSINTERNAL_HASH_SEED 2166136261u
+
+inline bsint_u32 BSInternal_HashBytes(bsint_u32 hash, const void *data, bsint_mem_index size)
+{
+    const bsint_u8 *bytes = (const bsint_u8 *)data;
+    while (size--)
+    {
+        hash = (hash ^ *bytes++) * 16777619u;
+    }
+    
+    return hash;
+}
+
+inline bsint_b32 BSInternal_RectsOverlap(BSInternal_SizeSpec a, BSInternal_SizeSpec b)
+{
+    bsint_b32 result = ((a.x1 <= b.x2) && (b.x1 <= a.x2) && (a.y1 <= b.y2) && (b.y1 <= a.y2));
+    return result;
+}
+
+inline BSInternal_SizeSpec BSInternal_UnionRects(BSInternal_SizeSpec a, BSInternal_SizeSpec b)
+{
+    BSInternal_SizeSpec result = {};
+    
+    result.x1 = (a.x1 < b.x1) ? a.x1 : b.x1;
+    result.x2 = (a.x2 > b.x2) ? a.x2 : b.x2;
+    result.y1 = (a.y1 < b.y1) ? a.y1 : b.y1;
+    result.y2 = (a.y2 > b.y2) ? a.y2 : b.y2;
+    
+    return result;
+}
+
+inline BSInternal_SizeSpec BSInternal_OrderRect(BSInternal_SizeSpec rect)
+{
+    if (rect.x1 > rect.x2)
+    {
+        INTERNAL_SWAP(rect.x1, rect.x2);
+    }
+    if (rect.y1 > rect.y2)
+    {
+        INTERNAL_SWAP(rect.y1, rect.y2);
+    }
+    
+    return rect;
+}
+
+// NOTE(bSalmon): Called at the start and end of every widget so nested widgets get their own segments
+inline void BSInternal_BeginWidget()
+{
+    BSINTERNAL_CTX.drawList.segmentOpen = false;
+}
+
+inline void BSInternal_EndWidget()
+{
+    BSINTERNAL_CTX.drawList.segmentOpen = false;
+}
+
+bsint_function BSInternal_DrawCommand *BSInternal_PushDrawCommand(BSInternal_DrawCommandType type, BSInternal_SizeSpec bounds)
+{
+    BSInternal_DrawList *drawList = &BSINTERNAL_CTX.drawList;
+    
+    if (!drawList->segmentOpen)
+    {
+        if (drawList->segmentCount == drawList->segmentCapacity)
+        {
+            drawList->segmentCapacity = (drawList->segmentCapacity) ? drawList->segmentCapacity * 2 : 64;
+            drawList->segments = (BSInternal_DrawSegment *)BSINTERNAL_REALLOC(drawList->segments, drawList->segmentCapacity * sizeof(BSInternal_DrawSegment));
+        }
+        
+        BSInternal_DrawSegment *newSegment = &drawList->segments[drawList->segmentCount++];
+        *newSegment = {};
+        newSegment->hash = BSINTERNAL_HASH_SEED;
+        newSegment->bounds = bounds;
+        newSegment->window = BSINTERNAL_CTX.currentWindow;
+        newSegment->overlay = (!newSegment->window && BSINTERNAL_CTX.windowCount);
+        drawList->segmentOpen = true;
+        
+        // NOTE(bSalmon): A segment changing place in the stack has to redraw even if nothing in it changed
+        bsint_s32 zOrder = (newSegment->window) ? BSINTERNAL_CTX.windows[newSegment->window - 1].zOrder : newSegment->overlay;
+        newSegment->hash = BSInternal_HashBytes(newSegment->hash, &zOrder, sizeof(zOrder));
+    }
+    
+    BSInternal_DrawSegment *segment = &drawList->segments[drawList->segmentCount - 1];
+    BSInternal_DrawCommand *command = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, 1, BSInternal_DrawCommand);
+    *command = {};
+    command->type = type;
+    command->rect = bounds;
+    
+    if (segment->lastCommand)
+    {
+        segment->lastCommand->next = command;
+    }
+    else
+    {
+        segment->firstCommand = command;
+    }
+    segment->lastCommand = command;
+    segment->bounds = BSInternal_UnionRects(segment->bounds, bounds);
+    
+    return command;
+}
+
+inline void BSInternal_HashDrawCommand(BSInternal_DrawCommand *command)
+{
+    BSInternal_DrawSegment *segment = &BSINTERNAL_CTX.drawList.segments[BSINTERNAL_CTX.drawList.segmentCount - 1];
+    
+    bsint_u32 hash = segment->hash;
+    hash = BSInternal_HashBytes(hash, &command->type, sizeof(command->type));
+    hash = BSInternal_HashBytes(hash, &command->rect, sizeof(command->rect));
+    hash = BSInternal_HashBytes(hash, &command->lineThickness, sizeof(command->lineThickness));
+    hash = BSInternal_HashBytes(hash, &command->colour1, sizeof(command->colour1));
+    hash = BSInternal_HashBytes(hash, &command->colour2, sizeof(command->colour2));
+    if (command->type == DrawCommand_Text)
+    {
+        hash = BSInternal_HashBytes(hash, &command->fontInfo, sizeof(command->fontInfo));
+        hash = BSInternal_HashBytes(hash, &command->lineHeight, sizeof(command->lineHeight));
+        hash = BSInternal_HashBytes(hash, command->text, command->textLength);
+    }
+    else if (command->type == DrawCommand_Panel)
+    {
+        hash = BSInternal_HashBytes(hash, &command->panel->key, sizeof(command->panel->key));
+    }
+#ifdef BS842_IMGUI_IMAGES
+    else if (command->type == DrawCommand_Image)
+    {
+        hash = BSInternal_HashBytes(hash, &command->image->key, sizeof(command->image->key));
+    }
+#endif
+    
+    segment->hash = hash;
+}
+
+inline void BSInternal_PushSolidBox(BSInternal_SizeSpec sizeSpec, bsint_u32 colour)
+{
+    BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_SolidBox, BSInternal_OrderRect(sizeSpec));
+    command->colour1 = colour;
+    BSInternal_HashDrawCommand(command);
+}
+
+inline void BSInternal_PushSolidBox(BS842_Prim_SizeSpec sizeSpec, bsint_u32 colour)
+{
+    BSInternal_PushSolidBox(bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec), colour);
+}
+
+inline BSInternal_SizeSpec BSInternal_PadRect(BSInternal_SizeSpec rect, bsint_f32 lineThickness)
+{
+    bsint_s32 pad = (bsint_s32)lineThickness;
+    BSInternal_SizeSpec result = BS842_FillSizeSpec(rect.x1 - pad, rect.x2 + pad, rect.y1 - pad, rect.y2 + pad);
+    return result;
+}
+
+inline void BSInternal_PushHollowBox(BSInternal_SizeSpec sizeSpec, bsint_f32 lineThickness, bsint_u32 colour)
+{
+    sizeSpec = BSInternal_OrderRect(sizeSpec);
+    BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_HollowBox, BSInternal_PadRect(sizeSpec, lineThickness));
+    command->rect = sizeSpec;
+    command->lineThickness = lineThickness;
+    command->colour1 = colour;
+    BSInternal_HashDrawCommand(command);
+}
+
+inline void BSInternal_PushHollowBox(BS842_Prim_SizeSpec sizeSpec, bsint_f32 lineThickness, bsint_u32 colour)
+{
+    BSInternal_PushHollowBox(bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec), lineThickness, colour);
+}
+
+inline void BSInternal_PushOutlinedBox(BSInternal_SizeSpec sizeSpec, bsint_f32 lineThickness, bsint_u32 colour1, bsint_u32 colour2)
+{
+    sizeSpec = BSInternal_OrderRect(sizeSpec);
+    BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_OutlinedBox, BSInternal_PadRect(sizeSpec, lineThickness));
+    command->rect = sizeSpec;
+    command->lineThickness = lineThickness;
+    command->colour1 = colour1;
+    command->colour2 = colour2;
+    BSInternal_HashDrawCommand(command);
+}
+
+inline void BSInternal_PushOutlinedBox(BS842_Prim_SizeSpec sizeSpec, bsint_f32 lineThickness, bsint_u32 colour1, bsint_u32 colour2)
+{
+    BSInternal_PushOutlinedBox(bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec), lineThickness, colour1, colour2);
+}
+
+// NOTE(bSalmon): Lines keep their end points in rect, the bounds are ordered separately
+inline void BSInternal_PushLine(BS842_Prim_SizeSpec sizeSpec, bsint_f32 lineThickness, bsint_u32 colour)
+{
+    BSInternal_SizeSpec ends = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
+    BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_Line, BSInternal_PadRect(BSInternal_OrderRect(ends), lineThickness));
+    command->rect = ends;
+    command->lineThickness = lineThickness;
+    command->colour1 = colour;
+    BSInternal_HashDrawCommand(command);
+}
+
+// NOTE(bSalmon): Text is always top left aligned in the imgui, textLength of -1 means text is null terminated
+// NOTE(bSalmon): Doesn't copy, text has to stay valid until BS842_ImguiEnd. BSInternal_PushText is for everything else.
+// Callers that kept the extent from an earlier BS842_MeasureText can pass it to skip measuring again
+bsint_function void BSInternal_PushTextView(stbtt_fontinfo *fontInfo, const char *text, bsint_s32 textLength, bsint_f32 lineHeight, bsint_u32 colour, bsint_f32 xPosPercent, bsint_f32 yPosPercent,
+                                            bsint_s32 extentX = -1)
+{
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    
+    if (extentX < 0)
+    {
+        BS842_MeasureText(fontInfo, text, textLength, lineHeight, &extentX);
+    }
+    bsint_s32 xPos = bs842_prim_internal_RoundF32ToS32(backBuffer->width * xPosPercent);
+    bsint_s32 yPos = bs842_prim_internal_RoundF32ToS32(backBuffer->height * yPosPercent);
+    BSInternal_SizeSpec bounds = BS842_FillSizeSpec(xPos, xPos + extentX, yPos, yPos + (bsint_s32)(lineHeight * 1.25f) + 1);
+    
+    BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_Text, bounds);
+    command->colour1 = colour;
+    command->fontInfo = fontInfo;
+    command->text = text;
+    command->textLength = textLength;
+    command->lineHeight = lineHeight;
+    command->xPosPercent = xPosPercent;
+    command->yPosPercent = yPosPercent;
+    BSInternal_HashDrawCommand(command);
+}
+
+bsint_function void BSInternal_PushText(stbtt_fontinfo *fontInfo, const char *text, bsint_s32 textLength, bsint_f32 lineHeight, bsint_u32 colour, bsint_f32 xPosPercent, bsint_f32 yPosPercent)
+{
+    if (textLength < 0)
+    {
+        textLength = 0;
+        while (text[textLength])
+        {
+            ++textLength;
+        }
+    }
+    
+    char *textCopy = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, textLength + 1, char);
+    bs842_internal_CopyMem(textCopy, text, textLength);
+    textCopy[textLength] = '\0';
+    BSInternal_PushTextView(fontInfo, textCopy, textLength, lineHeight, colour, xPosPercent, yPosPercent);
+}
+
+inline BS842_ImguiID BSInternal_GetID(const char *label)
+{
+    BS842_ImguiID result = BSInternal_HashBytes(BSINTERNAL_HASH_SEED ^ BSINTERNAL_CTX.currentID, label, bs842_internal_StringLength(label));
+    result = (result == 0) ? BSINTERNAL_ROOT_ID : result;
+    
+    return result;
+}
+
+inline BS842_ImguiID BSInternal_GetID(bsint_s32 value)
+{
+    BS842_ImguiID result = BSInternal_HashBytes(BSINTERNAL_HASH_SEED ^ BSINTERNAL_CTX.currentID, &value, sizeof(value));
+    result = (result == 0) ? BSINTERNAL_ROOT_ID : result;
+    
+    return result;
+}
+
+inline void BS842_Imgui_PushID(const char *label)
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.idStackCount < BSINTERNAL_ID_STACK_SIZE);
+    
+    BS842_ImguiID id = BSInternal_GetID(label);
+    BSINTERNAL_CTX.idStack[BSINTERNAL_CTX.idStackCount++] = BSINTERNAL_CTX.currentID;
+    BSINTERNAL_CTX.currentID = id;
+}
+
+inline void BS842_Imgui_PopID()
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.idStackCount > 0);
+    
+    BSINTERNAL_CTX.currentID = BSINTERNAL_CTX.idStack[--BSINTERNAL_CTX.idStackCount];
+}
+
+bsint_function void BSInternal_RebuildStateTable(BSInternal_WidgetStateTable *table, bsint_s32 newCapacity)
+{
+    BSInternal_WidgetStateSlot *oldSlots = table->slots;
+    bsint_s32 oldCapacity = table->capacity;
+    
+    table->slots = (BSInternal_WidgetStateSlot *)BSINTERNAL_CALLOC(newCapacity, sizeof(BSInternal_WidgetStateSlot));
+    table->capacity = newCapacity;
+    table->count = 0;
+    
+    bsint_u32 mask = (bsint_u32)table->capacity - 1;
+    for (bsint_s32 oldIndex = 0; oldIndex < oldCapacity; ++oldIndex)
+    {
+        if (oldSlots[oldIndex].id)
+        {
+            bsint_u32 slot = oldSlots[oldIndex].id & mask;
+            while (table->slots[slot].id)
+            {
+                slot = (slot + 1) & mask;
+            }
+            
+            table->slots[slot] = oldSlots[oldIndex];
+            ++table->count;
+        }
+    }
+    
+    free(oldSlots);
+}
+
+bsint_function BSInternal_WidgetState *BSInternal_GetWidgetState(BS842_ImguiID id)
+{
+    BSInternal_WidgetStateTable *table = &BSINTERNAL_CTX.stateTable;
+    
+    if ((table->count + 1) * 4 > table->capacity * 3)
+    {
+        BSInternal_RebuildStateTable(table, (table->capacity) ? table->capacity * 2 : 64);
+    }
+    
+    bsint_u32 mask = (bsint_u32)table->capacity - 1;
+    bsint_u32 slot = id & mask;
+    while (table->slots[slot].id && (table->slots[slot].id != id))
+    {
+        slot = (slot + 1) & mask;
+    }
+    
+    if (!table->slots[slot].id)
+    {
+        BSInternal_WidgetState *newState = (BSInternal_WidgetState *)BSInternal_PoolAlloc(&table->statePool, sizeof(BSInternal_WidgetState));
+        *newState = {};
+        newState->id = id;
+        
+        table->slots[slot].id = id;
+        table->slots[slot].state = newState;
+        ++table->count;
+    }
+    
+    BSInternal_WidgetState *result = table->slots[slot].state;
+    result->lastFrameSeen = BSINTERNAL_CTX.frameIndex;
+    
+    return result;
+}
+
+inline void BSInternal_ReleaseWidgetState(BSInternal_WidgetStateTable *table, BSInternal_WidgetState *state)
+{
+    if (state->freeData)
+    {
+        state->freeData(state->data);
+    }
+    
+    BSInternal_PoolFree(&table->statePool, state);
+}
+
+// NOTE(bSalmon): Rebuilding is simpler than deleting in place from a linear probed table and only happens when something is stale
+bsint_function void BSInternal_EvictWidgetStates()
+{
+    BSInternal_WidgetStateTable *table = &BSINTERNAL_CTX.stateTable;
+    
+    bsint_b32 anyStale = false;
+    for (bsint_s32 slot = 0; slot < table->capacity; ++slot)
+    {
+        BSInternal_WidgetStateSlot *stateSlot = &table->slots[slot];
+        if (stateSlot->id && ((BSINTERNAL_CTX.frameIndex - stateSlot->state->lastFrameSeen) > BSINTERNAL_STATE_EVICT_FRAMES))
+        {
+            BSInternal_ReleaseWidgetState(table, stateSlot->state);
+            *stateSlot = {};
+            anyStale = true;
+        }
+    }
+    
+    if (anyStale)
+    {
+        BSInternal_RebuildStateTable(table, table->capacity);
+    }
+}
+
+// NOTE(bSalmon): hot is the widget under the mouse this frame, active is the last widget clicked and stays so until a click lands elsewhere
+inline void BSInternal_UpdateHotActive(BS842_ImguiID id, bsint_b32 hovered)
+{
+    if (hovered)
+    {
+        BSINTERNAL_CTX.hotID = id;
+        if (BSINTERNAL_CTX.clicked || BSINTERNAL_CTX.dblClicked)
+        {
+            BSINTERNAL_CTX.activeID = id;
+            BSINTERNAL_CTX.clickClaimed = true;
+        }
+    }
+}
+
+// NOTE(bSalmon): Later rects are drawn over earlier ones so each cell keeps them in registration order, the query
+// walks back from the end
+bsint_function void BSInternal_BuildHitGrid()
+{
+    BSInternal_HitGrid *grid = &BSINTERNAL_CTX.hitGrid;
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    
+    BSInternal_HitRect *swapRects = grid->gridRects;
+    bsint_s32 swapCapacity = grid->gridRectCapacity;
+    grid->gridRects = grid->rects;
+    grid->gridRectCount = grid->rectCount;
+    grid->gridRectCapacity = grid->rectCapacity;
+    grid->rects = swapRects;
+    grid->rectCount = 0;
+    grid->rectCapacity = swapCapacity;
+    
+    grid->cellsX = (backBuffer->width + (BSINTERNAL_HIT_CELL_SIZE - 1)) / BSINTERNAL_HIT_CELL_SIZE;
+    grid->cellsY = (backBuffer->height + (BSINTERNAL_HIT_CELL_SIZE - 1)) / BSINTERNAL_HIT_CELL_SIZE;
+    bsint_s32 cellCount = grid->cellsX * grid->cellsY;
+    if ((cellCount + 1) > grid->cellStartCapacity)
+    {
+        grid->cellStartCapacity = cellCount + 1;
+        grid->cellStart = (bsint_s32 *)BSINTERNAL_REALLOC(grid->cellStart, grid->cellStartCapacity * sizeof(bsint_s32));
+    }
+    for (bsint_s32 cell = 0; cell <= cellCount; ++cell)
+    {
+        grid->cellStart[cell] = 0;
+    }
+    
+    // NOTE(bSalmon): Rects are clipped to the backbuffer, anything entirely off it never lands in a cell
+    bsint_s32 *cellRange = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, grid->gridRectCount * 4, bsint_s32);
+    for (bsint_s32 rectIndex = 0; rectIndex < grid->gridRectCount; ++rectIndex)
+    {
+        BSInternal_SizeSpec rect = grid->gridRects[rectIndex].rect;
+        bsint_s32 *range = &cellRange[rectIndex * 4];
+        if ((rect.x2 < 0) || (rect.y2 < 0) || (rect.x1 >= backBuffer->width) || (rect.y1 >= backBuffer->height))
+        {
+            range[0] = range[2] = 1;
+            range[1] = range[3] = 0;
+            continue;
+        }
+        
+        range[0] = ((rect.x1 > 0) ? rect.x1 : 0) / BSINTERNAL_HIT_CELL_SIZE;
+        range[1] = ((rect.x2 < backBuffer->width) ? rect.x2 : backBuffer->width - 1) / BSINTERNAL_HIT_CELL_SIZE;
+        range[2] = ((rect.y1 > 0) ? rect.y1 : 0) / BSINTERNAL_HIT_CELL_SIZE;
+        range[3] = ((rect.y2 < backBuffer->height) ? rect.y2 : backBuffer->height - 1) / BSINTERNAL_HIT_CELL_SIZE;
+        
+        for (bsint_s32 cellY = range[2]; cellY <= range[3]; ++cellY)
+        {
+            for (bsint_s32 cellX = range[0]; cellX <= range[1]; ++cellX)
+            {
+                ++grid->cellStart[(cellY * grid->cellsX) + cellX + 1];
+            }
+        }
+    }
+    
+    for (bsint_s32 cell = 0; cell < cellCount; ++cell)
+    {
+        grid->cellStart[cell + 1] += grid->cellStart[cell];
+    }
+    
+    if (grid->cellStart[cellCount] > grid->cellRectCapacity)
+    {
+        grid->cellRectCapacity = grid->cellStart[cellCount];
+        grid->cellRects = (bsint_s32 *)BSINTERNAL_REALLOC(grid->cellRects, grid->cellRectCapacity * sizeof(bsint_s32));
+    }
+    
+    bsint_s32 *cursor = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, cellCount, bsint_s32);
+    bs842_internal_CopyMem(cursor, grid->cellStart, cellCount * sizeof(bsint_s32));
+    for (bsint_s32 rectIndex = 0; rectIndex < grid->gridRectCount; ++rectIndex)
+    {
+        bsint_s32 *range = &cellRange[rectIndex * 4];
+        for (bsint_s32 cellY = range[2]; cellY <= range[3]; ++cellY)
+        {
+            for (bsint_s32 cellX = range[0]; cellX <= range[1]; ++cellX)
+            {
+                grid->cellRects[cursor[(cellY * grid->cellsX) + cellX]++] = rectIndex;
+            }
+        }
+    }
+}
+
+bsint_function void BSInternal_QueryHitGrid()
+{
+    BSInternal_HitGrid *grid = &BSINTERNAL_CTX.hitGrid;
+    grid->hoveredID = 0;
+    grid->hoveredWindowID = 0;
+    
+    bsint_s32 mouseX = BSINTERNAL_CTX.mouseX;
+    bsint_s32 mouseY = BSINTERNAL_CTX.mouseY;
+    if ((mouseX < 0) || (mouseY < 0))
+    {
+        return;
+    }
+    
+    bsint_s32 cellX = mouseX / BSINTERNAL_HIT_CELL_SIZE;
+    bsint_s32 cellY = mouseY / BSINTERNAL_HIT_CELL_SIZE;
+    if ((cellX >= grid->cellsX) || (cellY >= grid->cellsY))
+    {
+        return;
+    }
+    
+    bsint_s32 cell = (cellY * grid->cellsX) + cellX;
+    bsint_s32 bestLayer = -1;
+    for (bsint_s32 cellIndex = grid->cellStart[cell + 1] - 1; cellIndex >= grid->cellStart[cell]; --cellIndex)
+    {
+        BSInternal_HitRect *hitRect = &grid->gridRects[grid->cellRects[cellIndex]];
+        if ((hitRect->layer > bestLayer) &&
+            (mouseX >= hitRect->rect.x1) && (mouseX <= hitRect->rect.x2) &&
+            (mouseY >= hitRect->rect.y1) && (mouseY <= hitRect->rect.y2))
+        {
+            grid->hoveredID = hitRect->id;
+            grid->hoveredWindowID = hitRect->window;
+            bestLayer = hitRect->layer;
+        }
+    }
+}
+
+// NOTE(bSalmon): For widgets that take the mouse. The rect goes into next frame's grid, and only the widget the grid
+// found under the mouse checks its rect this frame, in case it moved since
+inline bsint_b32 BSInternal_HitTest(BS842_ImguiID id, BSInternal_SizeSpec rect)
+{
+    BSInternal_HitGrid *grid = &BSINTERNAL_CTX.hitGrid;
+    if (grid->rectCount == grid->rectCapacity)
+    {
+        grid->rectCapacity = (grid->rectCapacity) ? grid->rectCapacity * 2 : 64;
+        grid->rects = (BSInternal_HitRect *)BSINTERNAL_REALLOC(grid->rects, grid->rectCapacity * sizeof(BSInternal_HitRect));
+    }
+    BSInternal_HitRect *hitRect = &grid->rects[grid->rectCount++];
+    hitRect->id = id;
+    hitRect->rect = rect;
+    hitRect->window = 0;
+    hitRect->layer = (BSINTERNAL_CTX.windowCount) ? BSINTERNAL_OVERLAY_LAYER : 0;
+    if (BSINTERNAL_CTX.currentWindow)
+    {
+        BSInternal_Window *window = &BSINTERNAL_CTX.windows[BSINTERNAL_CTX.currentWindow - 1];
+        hitRect->window = window->id;
+        hitRect->layer = window->zOrder;
+    }
+    
+    bsint_b32 result = false;
+    if (id == grid->hoveredID)
+    {
+        result = (((BSINTERNAL_CTX.mouseX >= rect.x1) && (BSINTERNAL_CTX.mouseX <= rect.x2)) &&
+                  ((BSINTERNAL_CTX.mouseY >= rect.y1) && (BSINTERNAL_CTX.mouseY <= rect.y2))) ? true : false;
+    }
+    BSInternal_UpdateHotActive(id, result);
+    
+    return result;
+}
+
+inline bsint_b32 BS842_Imgui_IsHot(BS842_ImguiID id)
+{
+    return (BSINTERNAL_CTX.hotID == id);
+}
+
+inline bsint_b32 BS842_Imgui_IsActive(BS842_ImguiID id)
+{
+    return (BSINTERNAL_CTX.activeID == id);
+}
+
+// NOTE(bSalmon): What's left of rect with hole taken out, as up to 4 rects. Inclusive coordinates
+inline bsint_s32 BSInternal_SubtractRect(BSInternal_SizeSpec rect, BSInternal_SizeSpec hole, BSInternal_SizeSpec *pieces)
+{
+    if (!BSInternal_RectsOverlap(rect, hole))
+    {
+        pieces[0] = rect;
+        return 1;
+    }
+    
+    bsint_s32 result = 0;
+    if (hole.y1 > rect.y1)
+    {
+        pieces[result++] = BS842_FillSizeSpec(rect.x1, rect.x2, rect.y1, hole.y1 - 1);
+    }
+    if (hole.y2 < rect.y2)
+    {
+        pieces[result++] = BS842_FillSizeSpec(rect.x1, rect.x2, hole.y2 + 1, rect.y2);
+    }
+    
+    bsint_s32 middleY1 = (hole.y1 > rect.y1) ? hole.y1 : rect.y1;
+    bsint_s32 middleY2 = (hole.y2 < rect.y2) ? hole.y2 : rect.y2;
+    if (hole.x1 > rect.x1)
+    {
+        pieces[result++] = BS842_FillSizeSpec(rect.x1, hole.x1 - 1, middleY1, middleY2);
+    }
+    if (hole.x2 < rect.x2)
+    {
+        pieces[result++] = BS842_FillSizeSpec(hole.x2 + 1, rect.x2, middleY1, middleY2);
+    }
+    
+    return result;
+}
+
+#define BSINTERNAL_MAX_VISIBLE_FRAGMENTS 64
+
+// NOTE(bSalmon): The parts of rect no occluder covers. Returns -1 if that gets too fragmented to track, the caller
+// should treat rect as fully visible
+bsint_function bsint_s32 BSInternal_VisibleFragments(BSInternal_SizeSpec rect, BSInternal_SizeSpec *occluders, bsint_s32 occluderCount, BSInternal_SizeSpec *fragments)
+{
+    fragments[0] = rect;
+    bsint_s32 result = 1;
+    
+    for (bsint_s32 occluderIndex = 0; (occluderIndex < occluderCount) && result; ++occluderIndex)
+    {
+        BSInternal_SizeSpec remaining[BSINTERNAL_MAX_VISIBLE_FRAGMENTS];
+        bsint_s32 remainingCount = 0;
+        for (bsint_s32 fragmentIndex = 0; fragmentIndex < result; ++fragmentIndex)
+        {
+            BSInternal_SizeSpec pieces[4];
+            bsint_s32 pieceCount = BSInternal_SubtractRect(fragments[fragmentIndex], occluders[occluderIndex], pieces);
+            if ((remainingCount + pieceCount) > BSINTERNAL_MAX_VISIBLE_FRAGMENTS)
+            {
+                return -1;
+            }
+            
+            for (bsint_s32 pieceIndex = 0; pieceIndex < pieceCount; ++pieceIndex)
+            {
+                remaining[remainingCount++] = pieces[pieceIndex];
+            }
+        }
+        
+        bs842_internal_CopyMem(fragments, remaining, remainingCount * sizeof(BSInternal_SizeSpec));
+        result = remainingCount;
+    }
+    
+    return result;
+}
+
+// NOTE(bSalmon): occluders are the windows stacked above this segment, solid boxes only fill what they leave showing
+bsint_function void BSInternal_RasteriseSegment(BSInternal_DrawSegment *segment, BSInternal_SizeSpec *occluders, bsint_s32 occluderCount)
+{
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    BS842_TextBatch *textBatch = &BSINTERNAL_CTX.textBatch;
+    
+    for (BSInternal_DrawCommand *command = segment->firstCommand; command; command = command->next)
+    {
+        if (command->type == DrawCommand_Text)
+        {
+            BS842_TextBatchPush(textBatch, backBuffer, command->fontInfo, command->text, command->textLength, command->lineHeight,
+                                command->colour1, command->xPosPercent, command->yPosPercent, true);
+            continue;
+        }
+        
+        // NOTE(bSalmon): Consecutive text is composited together, but has to land before anything drawn over it
+        if (textBatch->itemCount)
+        {
+            BS842_TextBatchFlush(backBuffer, textBatch);
+        }
+        
+        switch (command->type)
+        {
+            case DrawCommand_SolidBox:
+            {
+                BSInternal_SizeSpec fragments[BSINTERNAL_MAX_VISIBLE_FRAGMENTS];
+                bsint_s32 fragmentCount = -1;
+                if (occluderCount && (command->rect.x2 > command->rect.x1))
+                {
+                    BSInternal_SizeSpec covered = BS842_FillSizeSpec(command->rect.x1, command->rect.x2 - 1, command->rect.y1, command->rect.y2);
+                    fragmentCount = BSInternal_VisibleFragments(covered, occluders, occluderCount, fragments);
+                }
+                
+                if (fragmentCount < 0)
+                {
+                    BS842_DrawSolidBox(backBuffer, command->rect, command->colour1);
+                }
+                for (bsint_s32 fragmentIndex = 0; fragmentIndex < fragmentCount; ++fragmentIndex)
+                {
+                    BSInternal_SizeSpec fragment = fragments[fragmentIndex];
+                    BS842_DrawSolidBox(backBuffer, BS842_FillSizeSpec(fragment.x1, fragment.x2 + 1, fragment.y1, fragment.y2), command->colour1);
+                }
+            } break;
+            
+            case DrawCommand_HollowBox:
+            {
+                BS842_DrawHollowBox(backBuffer, command->rect, command->lineThickness, command->colour1);
+            } break;
+            
+            case DrawCommand_OutlinedBox:
+            {
+                BS842_DrawOutlinedBox(backBuffer, command->rect, command->lineThickness, command->colour1, command->colour2);
+            } break;
+            
+            case DrawCommand_Line:
+            {
+                BS842_DrawLine(backBuffer, command->rect, command->lineThickness, command->colour1);
+            } break;
+            
+            // NOTE(bSalmon): Like solid boxes, runs are only copied where the windows above leave the panel showing
+            case DrawCommand_Panel:
+            {
+                BSInternal_PanelCache *panel = command->panel;
+                BSInternal_SizeSpec fragments[BSINTERNAL_MAX_VISIBLE_FRAGMENTS];
+                bsint_s32 fragmentCount = -1;
+                if (occluderCount)
+                {
+                    fragmentCount = BSInternal_VisibleFragments(panel->bounds, occluders, occluderCount, fragments);
+                }
+                if (fragmentCount < 0)
+                {
+                    fragments[0] = panel->bounds;
+                    fragmentCount = 1;
+                }
+                
+                for (bsint_s32 fragmentIndex = 0; fragmentIndex < fragmentCount; ++fragmentIndex)
+                {
+                    BSInternal_SizeSpec fragment = fragments[fragmentIndex];
+                    for (bsint_s32 runIndex = 0; runIndex < panel->runCount; ++runIndex)
+                    {
+                        BSInternal_PanelRun *run = &panel->runs[runIndex];
+                        bsint_s32 x1 = (run->x > fragment.x1) ? run->x : fragment.x1;
+                        bsint_s32 x2 = ((run->x + run->length - 1) < fragment.x2) ? (run->x + run->length - 1) : fragment.x2;
+                        if ((run->y < fragment.y1) || (run->y > fragment.y2) || (x1 > x2))
+                        {
+                            continue;
+                        }
+                        
+                        bsint_u32 *dest = (bsint_u32 *)((bsint_u8 *)backBuffer->memory + (run->y * backBuffer->pitch));
+                        bsint_u32 *src = panel->pixels + run->offset - run->x;
+                        for (bsint_s32 x = x1; x <= x2; ++x)
+                        {
+                            dest[x] = src[x];
+                        }
+                    }
+                }
+            } break;
+            
+#ifdef BS842_IMGUI_IMAGES
+            // NOTE(bSalmon): rect is where the image's top left lands and how much of it shows, inclusive. Only what's on
+            // the back buffer and left showing by the windows above gets drawn
+            case DrawCommand_Image:
+            {
+                BSInternal_ImageEntry *image = command->image;
+                BSInternal_SizeSpec visible = command->rect;
+                visible.x1 = (visible.x1 > 0) ? visible.x1 : 0;
+                visible.y1 = (visible.y1 > 0) ? visible.y1 : 0;
+                visible.x2 = (visible.x2 < backBuffer->width) ? visible.x2 : backBuffer->width - 1;
+                visible.y2 = (visible.y2 < backBuffer->height) ? visible.y2 : backBuffer->height - 1;
+                if ((visible.x1 > visible.x2) || (visible.y1 > visible.y2))
+                {
+                    break;
+                }
+                
+                BSInternal_SizeSpec fragments[BSINTERNAL_MAX_VISIBLE_FRAGMENTS];
+                bsint_s32 fragmentCount = -1;
+                if (occluderCount)
+                {
+                    fragmentCount = BSInternal_VisibleFragments(visible, occluders, occluderCount, fragments);
+                }
+                if (fragmentCount < 0)
+                {
+                    fragments[0] = visible;
+                    fragmentCount = 1;
+                }
+                
+                for (bsint_s32 fragmentIndex = 0; fragmentIndex < fragmentCount; ++fragmentIndex)
+                {
+                    BSInternal_SizeSpec fragment = fragments[fragmentIndex];
+                    for (bsint_s32 y = fragment.y1; y <= fragment.y2; ++y)
+                    {
+                        bsint_u32 *dest = (bsint_u32 *)((bsint_u8 *)backBuffer->memory + (y * backBuffer->pitch));
+                        bsint_u32 *src = image->pixels + ((y - command->rect.y1) * image->width) - command->rect.x1;
+                        for (bsint_s32 x = fragment.x1; image->opaque && (x <= fragment.x2); ++x)
+                        {
+                            dest[x] = src[x];
+                        }
+                        
+                        for (bsint_s32 x = fragment.x1; !image->opaque && (x <= fragment.x2); ++x)
+                        {
+                            bsint_u32 alpha = src[x] >> 24;
+                            if (alpha == 0xFF)
+                            {
+                                dest[x] = src[x];
+                            }
+                            else if (alpha)
+                            {
+                                bsint_u32 inverse = 255 - alpha;
+                                bsint_u32 newR = ((src[x] >> 16) & 0xFF) + ((((dest[x] >> 16) & 0xFF) * inverse) / 255);
+                                bsint_u32 newG = ((src[x] >> 8) & 0xFF) + ((((dest[x] >> 8) & 0xFF) * inverse) / 255);
+                                bsint_u32 newB = (src[x] & 0xFF) + (((dest[x] & 0xFF) * inverse) / 255);
+                                dest[x] = (0xFF << 24) | (newR << 16) | (newG << 8) | newB;
+                            }
+                        }
+                    }
+                }
+            } break;
+#endif
+            
+            default: break;
+        }
+    }
+}
+
+bsint_function void BSInternal_RasteriseDrawList()
+{
+    BSInternal_DrawList *drawList = &BSINTERNAL_CTX.drawList;
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    
+    bsint_b32 fullRedraw = (!drawList->retained || drawList->fullRedraw ||
+                            (drawList->prevWidth != backBuffer->width) || (drawList->prevHeight != backBuffer->height));
+    
+    // NOTE(bSalmon): Worst case is the current and previous bounds of every segment plus every segment pulled in by overlap
+    bsint_s32 dirtyCount = 0;
+    bsint_s32 maxDirty = ((drawList->segmentCount > drawList->prevCount) ? drawList->segmentCount * 2 : drawList->prevCount * 2) + drawList->segmentCount;
+    if (maxDirty > drawList->dirtyCapacity)
+    {
+        drawList->dirtyCapacity = maxDirty;
+        drawList->dirtyRects = (BSInternal_SizeSpec *)BSINTERNAL_REALLOC(drawList->dirtyRects, drawList->dirtyCapacity * sizeof(BSInternal_SizeSpec));
+    }
+    
+    if (fullRedraw)
+    {
+        if (drawList->retained)
+        {
+            BS842_Clear(backBuffer, drawList->clearColour);
+        }
+        
+        for (bsint_s32 segmentIndex = 0; segmentIndex < drawList->segmentCount; ++segmentIndex)
+        {
+            drawList->segments[segmentIndex].needsRaster = true;
+        }
+    }
+    else
+    {
+        // NOTE(bSalmon): Both where a changed segment was and where it is now have to be cleared and redrawn
+        for (bsint_s32 segmentIndex = 0; segmentIndex < drawList->segmentCount; ++segmentIndex)
+        {
+            BSInternal_DrawSegment *segment = &drawList->segments[segmentIndex];
+            segment->needsRaster = ((segmentIndex >= drawList->prevCount) || (segment->hash != drawList->prevHashes[segmentIndex]) ||
+                                    (segment->bounds.x1 != drawList->prevBounds[segmentIndex].x1) || (segment->bounds.x2 != drawList->prevBounds[segmentIndex].x2) ||
+                                    (segment->bounds.y1 != drawList->prevBounds[segmentIndex].y1) || (segment->bounds.y2 != drawList->prevBounds[segmentIndex].y2));
+            if (segment->needsRaster)
+            {
+                drawList->dirtyRects[dirtyCount++] = segment->bounds;
+                if (segmentIndex < drawList->prevCount)
+                {
+                    drawList->dirtyRects[dirtyCount++] = drawList->prevBounds[segmentIndex];
+                }
+            }
+        }
+        
+        for (bsint_s32 segmentIndex = drawList->segmentCount; segmentIndex < drawList->prevCount; ++segmentIndex)
+        {
+            drawList->dirtyRects[dirtyCount++] = drawList->prevBounds[segmentIndex];
+        }
+        
+        // NOTE(bSalmon): Text blends so a segment can't be drawn twice over itself, anything touching a dirty region is
+        // redrawn in full and its whole area becomes dirty too, until nothing new gets pulled in
+        bsint_b32 pulledIn = true;
+        while (pulledIn)
+        {
+            pulledIn = false;
+            for (bsint_s32 segmentIndex = 0; segmentIndex < drawList->segmentCount; ++segmentIndex)
+            {
+                BSInternal_DrawSegment *segment = &drawList->segments[segmentIndex];
+                for (bsint_s32 dirtyIndex = 0; !segment->needsRaster && (dirtyIndex < dirtyCount); ++dirtyIndex)
+                {
+                    if (BSInternal_RectsOverlap(segment->bounds, drawList->dirtyRects[dirtyIndex]))
+                    {
+                        segment->needsRaster = true;
+                        drawList->dirtyRects[dirtyCount++] = segment->bounds;
+                        pulledIn = true;
+                    }
+                }
+            }
+        }
+        
+        for (bsint_s32 dirtyIndex = 0; dirtyIndex < dirtyCount; ++dirtyIndex)
+        {
+            BSInternal_SizeSpec dirty = drawList->dirtyRects[dirtyIndex];
+            dirty.x1 = (dirty.x1 < 0) ? 0 : dirty.x1;
+            dirty.y1 = (dirty.y1 < 0) ? 0 : dirty.y1;
+            dirty.x2 = (dirty.x2 >= backBuffer->width) ? backBuffer->width - 1 : dirty.x2;
+            dirty.y2 = (dirty.y2 >= backBuffer->height) ? backBuffer->height - 1 : dirty.y2;
+            if ((dirty.x1 <= dirty.x2) && (dirty.y1 <= dirty.y2))
+            {
+                BS842_DrawSolidBox(backBuffer, BS842_FillSizeSpec(dirty.x1, dirty.x2 + 1, dirty.y1, dirty.y2), drawList->clearColour);
+            }
+        }
+    }
+    
+    // NOTE(bSalmon): Segments outside windows before the first one, then each window bottom to top, then overlay.
+    // Everything is tested against the windows above it and skipped if they cover it completely
+    bsint_s32 windowCount = BSINTERNAL_CTX.windowCount;
+    BSInternal_Window *windows = BSINTERNAL_CTX.windows;
+    bsint_s32 *windowOrder = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, windowCount + 2, bsint_s32);
+    BSInternal_SizeSpec *occluders = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, windowCount + 1, BSInternal_SizeSpec);
+    for (bsint_s32 windowIndex = 0; windowIndex < windowCount; ++windowIndex)
+    {
+        bsint_s32 insertAt = windowIndex;
+        while ((insertAt > 0) && (windows[windowOrder[insertAt - 1] - 1].zOrder > windows[windowIndex].zOrder))
+        {
+            windowOrder[insertAt] = windowOrder[insertAt - 1];
+            --insertAt;
+        }
+        windowOrder[insertAt] = windowIndex + 1;
+    }
+    
+    drawList->rasterisedCount = 0;
+    drawList->culledCount = 0;
+    for (bsint_s32 layer = -1; layer <= windowCount; ++layer)
+    {
+        bsint_s32 window = ((layer >= 0) && (layer < windowCount)) ? windowOrder[layer] : 0;
+        bsint_b32 overlay = (layer == windowCount);
+        
+        bsint_s32 occluderCount = 0;
+        for (bsint_s32 above = (layer + 1); !overlay && (above < windowCount); ++above)
+        {
+            occluders[occluderCount++] = windows[windowOrder[above] - 1].rect;
+        }
+        
+        for (bsint_s32 segmentIndex = 0; segmentIndex < drawList->segmentCount; ++segmentIndex)
+        {
+            BSInternal_DrawSegment *segment = &drawList->segments[segmentIndex];
+            if (!segment->needsRaster || (segment->window != window) || (segment->overlay != overlay))
+            {
+                continue;
+            }
+            
+            BSInternal_SizeSpec fragments[BSINTERNAL_MAX_VISIBLE_FRAGMENTS];
+            if (occluderCount && (BSInternal_VisibleFragments(segment->bounds, occluders, occluderCount, fragments) == 0))
+            {
+                ++drawList->culledCount;
+                continue;
+            }
+            
+            BSInternal_RasteriseSegment(segment, occluders, occluderCount);
+            ++drawList->rasterisedCount;
+        }
+    }
+    
+    if (BSINTERNAL_CTX.textBatch.itemCount)
+    {
+        BS842_TextBatchFlush(backBuffer, &BSINTERNAL_CTX.textBatch);
+    }
+    
+    if (drawList->segmentCount > drawList->prevCapacity)
+    {
+        drawList->prevCapacity = drawList->segmentCapacity;
+        drawList->prevHashes = (bsint_u32 *)BSINTERNAL_REALLOC(drawList->prevHashes, drawList->prevCapacity * sizeof(bsint_u32));
+        drawList->prevBounds = (BSInternal_SizeSpec *)BSINTERNAL_REALLOC(drawList->prevBounds, drawList->prevCapacity * sizeof(BSInternal_SizeSpec));
+    }
+    
+    for (bsint_s32 segmentIndex = 0; segmentIndex < drawList->segmentCount; ++segmentIndex)
+    {
+        drawList->prevHashes[segmentIndex] = drawList->segments[segmentIndex].hash;
+        drawList->prevBounds[segmentIndex] = drawList->segments[segmentIndex].bounds;
+    }
+    drawList->prevCount = drawList->segmentCount;
+    drawList->prevWidth = backBuffer->width;
+    drawList->prevHeight = backBuffer->height;
+    drawList->fullRedraw = false;
+    
+    drawList->segmentCount = 0;
+    drawList->segmentOpen = false;
+    BSINTERNAL_CTX.windowCount = 0;
+    BSINTERNAL_CTX.currentWindow = 0;
+}
+
+enum BS842_Themes
+{
+    Theme_Light,
+    Theme_Dark,
+    Theme_TTR,
+    Theme_Count,
+};
+
+bsint_function BSInternal_Theme BSInternal_LoadTheme(bsint_s32 theme)
+{
+    BSInternal_Theme result = {};
+    
+    switch (theme)
+    {
+        case Theme_TTR:
+        {
+            result.elemOutline = 0xFFFF0000;
+            result.elemBackground = 0xFF4D4D4D;
+            result.defaultText = 0xFFFFFFFF;
+             result.menuBarBackground = 0xFF181818;
+            result.menuItemBorder = 0xFFF3F3F3;
+            result.menuItemHovered = 0xFFFF0000;
+            result.fileBrowseFolder = 0xFFAAAAAA;
+            result.fileBrowseFile = 0xFFFFFFFF;
+            result.fileBrowseInvert = 0xFF000000;
+            result.fileBrowseSelected = 0xFFFF0000;
+            result.fileBrowseSelectedBar = 0xFFF3F3F3;
+            break;
+        }
+        
+        default:
+        {
+            break;
+        }
+    }
+    
+    return result;
+}
+
+#if 1
+#define INTERNAL_ASSERT(expr) if (!(expr)) {*(bsint_s32 *)0 = 0;}
+#else
+#define INTERNAL_ASSERT(expr) 
+#endif
+
+#ifdef BS842_IMGUI_IMAGES
+// NOTE(bSalmon): Box filtered to the requested size, premultiplied before averaging so transparent pixels don't bleed
+// their colour into the edges. Runs on the worker on Linux
+bsint_function void BSInternal_DecodeImage(BSInternal_ImageEntry *entry)
+{
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    int channels = 0;
+    unsigned char *source = stbi_load(entry->path, &sourceWidth, &sourceHeight, &channels, 4);
+    if (!source)
+    {
+        BSInternal_StoreRelease(&entry->status, ImageStatus_Failed);
+        return;
+    }
+    
+    bsint_s32 width = (entry->requestWidth) ? entry->requestWidth : sourceWidth;
+    bsint_s32 height = (entry->requestHeight) ? entry->requestHeight : sourceHeight;
+    bsint_u32 *pixels = (bsint_u32 *)BSINTERNAL_MALLOC(width * height * sizeof(bsint_u32));
+    bsint_b32 opaque = true;
+    
+    for (bsint_s32 y = 0; y < height; ++y)
+    {
+        bsint_s32 sourceY1 = (bsint_s32)(((bsint_u64)y * sourceHeight) / height);
+        bsint_s32 sourceY2 = (bsint_s32)(((bsint_u64)(y + 1) * sourceHeight) / height);
+        sourceY2 = (sourceY2 > sourceY1) ? sourceY2 : sourceY1 + 1;
+        for (bsint_s32 x = 0; x < width; ++x)
+        {
+            bsint_s32 sourceX1 = (bsint_s32)(((bsint_u64)x * sourceWidth) / width);
+            bsint_s32 sourceX2 = (bsint_s32)(((bsint_u64)(x + 1) * sourceWidth) / width);
+            sourceX2 = (sourceX2 > sourceX1) ? sourceX2 : sourceX1 + 1;
+            
+            // NOTE(bSalmon): A big enough downscale overflows 32 bit sums of premultiplied texels
+            bsint_u64 sumR = 0;
+            bsint_u64 sumG = 0;
+            bsint_u64 sumB = 0;
+            bsint_u64 sumA = 0;
+            for (bsint_s32 sourceY = sourceY1; sourceY < sourceY2; ++sourceY)
+            {
+                unsigned char *texel = source + (((sourceY * sourceWidth) + sourceX1) * 4);
+                for (bsint_s32 sourceX = sourceX1; sourceX < sourceX2; ++sourceX, texel += 4)
+                {
+                    sumR += texel[0] * texel[3];
+                    sumG += texel[1] * texel[3];
+                    sumB += texel[2] * texel[3];
+                    sumA += texel[3];
+                }
+            }
+            
+            bsint_u64 count = (bsint_u64)(sourceY2 - sourceY1) * (sourceX2 - sourceX1);
+            bsint_u32 alpha = (bsint_u32)(sumA / count);
+            bsint_u32 red = (bsint_u32)(sumR / (count * 255));
+            bsint_u32 green = (bsint_u32)(sumG / (count * 255));
+            bsint_u32 blue = (bsint_u32)(sumB / (count * 255));
+            opaque = opaque && (alpha == 0xFF);
+            pixels[(y * width) + x] = (alpha << 24) | (red << 16) | (green << 8) | blue;
+        }
+    }
+    stbi_image_free(source);
+    
+    entry->pixels = pixels;
+    entry->width = width;
+    entry->height = height;
+    entry->opaque = opaque;
+    BSInternal_StoreRelease(&entry->status, ImageStatus_Ready);
+}
+
+#if defined(BSINTERNAL_LINUX)
+bsint_function void *BSInternal_ImageWorker(void *param)
+{
+    BSInternal_ImageCache *cache = (BSInternal_ImageCache *)param;
+    
+    pthread_mutex_lock(&cache->mutex);
+    for (;;)
+    {
+        while (!cache->firstJob && !cache->quit)
+        {
+            pthread_cond_wait(&cache->jobReady, &cache->mutex);
+        }
+        if (cache->quit)
+        {
+            break;
+        }
+        
+        BSInternal_ImageEntry *entry = cache->firstJob;
+        cache->firstJob = entry->jobNext;
+        cache->lastJob = (cache->firstJob) ? cache->lastJob : 0;
+        pthread_mutex_unlock(&cache->mutex);
+        
+        BSInternal_DecodeImage(entry);
+        BSInternal_WakeContext(cache->context);
+        
+        pthread_mutex_lock(&cache->mutex);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+    
+    return 0;
+}
+#endif
+
+bsint_function void BSInternal_FreeImageEntry(BSInternal_ImageCache *cache, BSInternal_ImageEntry *entry)
+{
+    entry->lruPrev->lruNext = entry->lruNext;
+    entry->lruNext->lruPrev = entry->lruPrev;
+    
+    for (BSInternal_ImageEntry **link = &cache->buckets[entry->key % BSINTERNAL_IMAGE_BUCKETS]; *link; link = &(*link)->hashNext)
+    {
+        if (*link == entry)
+        {
+            *link = entry->hashNext;
+            break;
+        }
+    }
+    
+    if (entry->counted)
+    {
+        cache->usedBytes -= (bsint_mem_index)entry->width * entry->height * sizeof(bsint_u32);
+    }
+    free(entry->pixels);
+    free(entry);
+}
+
+// NOTE(bSalmon): Least recently used first, skipping anything still being decoded or drawn this frame
+bsint_function void BSInternal_TrimImageCache(BSInternal_ImageCache *cache)
+{
+    BSInternal_ImageEntry *entry = cache->lruSentinel.lruPrev;
+    while ((cache->usedBytes > cache->budgetBytes) && (entry != &cache->lruSentinel))
+    {
+        BSInternal_ImageEntry *prev = entry->lruPrev;
+        if ((BSInternal_LoadAcquire(&entry->status) != ImageStatus_Pending) && (entry->lastUsedFrame != BSINTERNAL_CTX.frameIndex))
+        {
+            BSInternal_FreeImageEntry(cache, entry);
+        }
+        entry = prev;
+    }
+}
+
+inline void BSInternal_InitImageCache(BSInternal_ImageCache *cache)
+{
+    if (!cache->lruSentinel.lruNext)
+    {
+        cache->lruSentinel.lruNext = &cache->lruSentinel;
+        cache->lruSentinel.lruPrev = &cache->lruSentinel;
+        cache->budgetBytes = (cache->budgetBytes) ? cache->budgetBytes : BSINTERNAL_IMAGE_DEFAULT_BUDGET;
+    }
+}
+
+// NOTE(bSalmon): Decodes on the worker on Linux, starting it the first time, otherwise (or if it can't start) right here
+bsint_function void BSInternal_QueueImageDecode(BSInternal_ImageCache *cache, BSInternal_ImageEntry *entry)
+{
+#if defined(BSINTERNAL_LINUX)
+    if (!cache->running)
+    {
+        cache->context = bs842_internal_context;
+        cache->quit = false;
+        pthread_mutex_init(&cache->mutex, 0);
+        pthread_cond_init(&cache->jobReady, 0);
+        cache->running = (pthread_create(&cache->thread, 0, BSInternal_ImageWorker, cache) == 0);
+        if (!cache->running)
+        {
+            pthread_cond_destroy(&cache->jobReady);
+            pthread_mutex_destroy(&cache->mutex);
+        }
+    }
+    
+    if (cache->running)
+    {
+        pthread_mutex_lock(&cache->mutex);
+        if (cache->lastJob)
+        {
+            cache->lastJob->jobNext = entry;
+        }
+        else
+        {
+            cache->firstJob = entry;
+        }
+        cache->lastJob = entry;
+        pthread_cond_signal(&cache->jobReady);
+        pthread_mutex_unlock(&cache->mutex);
+    }
+    else
+    {
+        BSInternal_DecodeImage(entry);
+    }
+#else
+    BSInternal_DecodeImage(entry);
+#endif
+}
+
+bsint_function BSInternal_ImageEntry *BSInternal_GetImage(char *path, bsint_s32 width, bsint_s32 height)
+{
+    BSInternal_ImageCache *cache = &BSINTERNAL_CTX.imageCache;
+    BSInternal_InitImageCache(cache);
+    
+    bsint_s32 pathLength = bs842_internal_StringLength(path);
+    bsint_u32 key = BSInternal_HashBytes(BSINTERNAL_HASH_SEED, path, pathLength);
+    key = BSInternal_HashBytes(key, &width, sizeof(width));
+    key = BSInternal_HashBytes(key, &height, sizeof(height));
+    
+    BSInternal_ImageEntry *entry = cache->buckets[key % BSINTERNAL_IMAGE_BUCKETS];
+    while (entry && !((entry->key == key) && (entry->requestWidth == width) && (entry->requestHeight == height) &&
+                      bs842_internal_StringCompare(entry->path, path)))
+    {
+        entry = entry->hashNext;
+    }
+    
+    if (!entry)
+    {
+        entry = (BSInternal_ImageEntry *)BSINTERNAL_CALLOC(1, sizeof(BSInternal_ImageEntry));
+        entry->key = key;
+        bs842_internal_CopyMem(entry->path, path, (pathLength < MAX_PATH) ? pathLength : MAX_PATH - 1);
+        entry->requestWidth = width;
+        entry->requestHeight = height;
+        entry->status = ImageStatus_Pending;
+        entry->hashNext = cache->buckets[key % BSINTERNAL_IMAGE_BUCKETS];
+        cache->buckets[key % BSINTERNAL_IMAGE_BUCKETS] = entry;
+        entry->lruPrev = &cache->lruSentinel;
+        entry->lruNext = cache->lruSentinel.lruNext;
+        entry->lruPrev->lruNext = entry;
+        entry->lruNext->lruPrev = entry;
+        
+        BSInternal_QueueImageDecode(cache, entry);
+    }
+    else if (entry != cache->lruSentinel.lruNext)
+    {
+        entry->lruPrev->lruNext = entry->lruNext;
+        entry->lruNext->lruPrev = entry->lruPrev;
+        entry->lruPrev = &cache->lruSentinel;
+        entry->lruNext = cache->lruSentinel.lruNext;
+        entry->lruPrev->lruNext = entry;
+        entry->lruNext->lruPrev = entry;
+    }
+    entry->lastUsedFrame = BSINTERNAL_CTX.frameIndex;
+    
+    // NOTE(bSalmon): The file may not exist yet or still be being written, so a failed load is tried again
+    // BSINTERNAL_IMAGE_RETRY_FRAMES frames after it's seen failing. An idle UI doesn't draw frames, so doesn't retry either
+    if (BSInternal_LoadAcquire(&entry->status) == ImageStatus_Failed)
+    {
+        if (!entry->retryScheduled)
+        {
+            entry->retryScheduled = true;
+            entry->retryFrame = BSINTERNAL_CTX.frameIndex + BSINTERNAL_IMAGE_RETRY_FRAMES;
+        }
+        else if ((BSINTERNAL_CTX.frameIndex - entry->retryFrame) >= 0)
+        {
+            entry->retryScheduled = false;
+            entry->status = ImageStatus_Pending;
+            entry->jobNext = 0;
+            BSInternal_QueueImageDecode(cache, entry);
+        }
+    }
+    
+    if (!entry->counted && (BSInternal_LoadAcquire(&entry->status) == ImageStatus_Ready))
+    {
+        entry->counted = true;
+        cache->usedBytes += (bsint_mem_index)entry->width * entry->height * sizeof(bsint_u32);
+        BSInternal_TrimImageCache(cache);
+    }
+    
+    return entry;
+}
+
+bsint_function void BSInternal_FreeImageCache()
+{
+    BSInternal_ImageCache *cache = &BSINTERNAL_CTX.imageCache;
+    
+#if defined(BSINTERNAL_LINUX)
+    if (cache->running)
+    {
+        pthread_mutex_lock(&cache->mutex);
+        cache->quit = true;
+        pthread_cond_signal(&cache->jobReady);
+        pthread_mutex_unlock(&cache->mutex);
+        pthread_join(cache->thread, 0);
+        pthread_cond_destroy(&cache->jobReady);
+        pthread_mutex_destroy(&cache->mutex);
+    }
+#endif
+    
+    if (cache->lruSentinel.lruNext)
+    {
+        while (cache->lruSentinel.lruNext != &cache->lruSentinel)
+        {
+            BSInternal_FreeImageEntry(cache, cache->lruSentinel.lruNext);
+        }
+    }
+    *cache = {};
+}
+
+// NOTE(bSalmon): Bytes of decoded pixels kept around, 16MB unless set. Images drawn this frame are kept even over budget
+inline void BS842_Imgui_SetImageCacheBudget(bsint_mem_index bytes)
+{
+    BSInternal_ImageCache *cache = &BSINTERNAL_CTX.imageCache;
+    BSInternal_InitImageCache(cache);
+    cache->budgetBytes = bytes;
+    BSInternal_TrimImageCache(cache);
+}
+#endif
+
+//////////////////
+
+enum BS842_InitCodes
+{
+    Init_Null,
+    Init_Success,
+    Init_FontFail, // Error from stbtt_InitFont()
+    Init_InvalidBackBuffer, // BackBuffer does not match BSInternal_BackBuffer, or format contains invalid values
+    Init_InvalidTheme, // Theme S32 does not correspond to a valid theme
+};
+
+bsint_function bsint_s32 BS842_InitImgui(bsint_u8* fontBuffer, bsint_u8* fileFontBuffer, void *backBuffer, bsint_s32 theme)
+{
+    bsint_s32 result = Init_Null;
+    
+    if (!stbtt_InitFont(&BSINTERNAL_CTX.fontInfo, fontBuffer, 0))
+    {
+        result = Init_FontFail;
+        return result;
+    }
+    
+    if (!stbtt_InitFont(&BSINTERNAL_CTX.fileFontInfo, fileFontBuffer, 0))
+    {
+        result = Init_FontFail;
+        return result;
+    }
+    
+     BSINTERNAL_CTX.backBuffer = (BSInternal_BackBuffer *)backBuffer;
+    if (!BSInternal_CheckBackBuffer(BSINTERNAL_CTX.backBuffer))
+    {
+        result = Init_InvalidBackBuffer;
+        return result;
+    }
+    
+    if (!(theme > -1) || !(theme < Theme_Count))
+    {
+        result = Init_InvalidTheme;
+        return result;
+    }
+    BSINTERNAL_CTX.theme = BSInternal_LoadTheme(theme);
+    
+    BSINTERNAL_CTX.clicked = false;
+    BSINTERNAL_CTX.mouseX = 0;
+    BSINTERNAL_CTX.mouseY = 0;
+    
+    BSINTERNAL_CTX.currentID = BSINTERNAL_ROOT_ID;
+    BSINTERNAL_CTX.idStackCount = 0;
+    
+    result = Init_Success;
+    return result;
+}
+
+bsint_function void BS842_ShutdownImgui()
+{
+#ifdef _WIN32
+    if (BSINTERNAL_CTX.redrawSignal.event)
+    {
+        CloseHandle(BSINTERNAL_CTX.redrawSignal.event);
+        BSINTERNAL_CTX.redrawSignal.event = 0;
+    }
+#endif
+    
+    BSInternal_ResetArena(&BSINTERNAL_CTX.frameArena);
+    free(BSINTERNAL_CTX.frameArena.base);
+    BSINTERNAL_CTX.frameArena = {};
+    
+    BSInternal_PoolRelease(&BSINTERNAL_CTX.stringNodePool);
+    
+    BSInternal_DrawList *drawList = &BSINTERNAL_CTX.drawList;
+    free(drawList->segments);
+    free(drawList->prevHashes);
+    free(drawList->prevBounds);
+    free(drawList->dirtyRects);
+    *drawList = {};
+    
+    BS842_TextBatchFree(&BSINTERNAL_CTX.textBatch);
+    
+    BSInternal_HitGrid *grid = &BSINTERNAL_CTX.hitGrid;
+    free(grid->rects);
+    free(grid->gridRects);
+    free(grid->cellStart);
+    free(grid->cellRects);
+    *grid = {};
+    
+    BSInternal_WidgetStateTable *table = &BSINTERNAL_CTX.stateTable;
+    for (bsint_s32 slot = 0; slot < table->capacity; ++slot)
+    {
+        if (table->slots[slot].id)
+        {
+            BSInternal_ReleaseWidgetState(table, table->slots[slot].state);
+        }
+    }
+    free(table->slots);
+    BSInternal_PoolRelease(&table->statePool);
+    *table = {};
+    
+#ifdef BS842_IMGUI_IMAGES
+    BSInternal_FreeImageCache();
+#endif
+}
+
+bsint_function void BS842_Imgui_DestroyContext(BS842_ImguiContext *context)
+{
+    INTERNAL_ASSERT(context != &bs842_internal_defaultContext);
+    
+    BS842_ImguiContext *previous = BS842_Imgui_SetContext(context);
+    BS842_ShutdownImgui();
+    BS842_Imgui_SetContext((previous == context) ? 0 : previous);
+    
+    free(context);
+}
+
+// NOTE(bSalmon): For anything the UI shows that changes outside of input, e.g. new telemetry arriving. Safe from any
+// thread, context is the one to wake, 0 is the calling thread's current context
+inline void BS842_Imgui_NotifyDataChanged(BS842_ImguiContext *context = 0)
+{
+    BSInternal_WakeContext((context) ? context : bs842_internal_context);
+}
+
+// NOTE(bSalmon): Asks for a frame within delayMicroseconds even if nothing else happens, for animations and polling.
+// Render thread only. Requests last until the next BS842_ImguiBegin, so anything that keeps animating asks every frame
+inline void BS842_Imgui_RequestRedraw(bsint_u64 delayMicroseconds = 0)
+{
+    BSInternal_RedrawSignal *signal = &BSINTERNAL_CTX.redrawSignal;
+    bsint_u64 deadline = BSInternal_GetTimestamp() + delayMicroseconds;
+    if (!signal->deadline || (deadline < signal->deadline))
+    {
+        signal->deadline = deadline;
+    }
+}
+
+inline bsint_b32 BSInternal_RedrawPending(bsint_u32 sequence, bsint_u64 now)
+{
+    BSInternal_RedrawSignal *signal = &BSINTERNAL_CTX.redrawSignal;
+    BSInternal_EventQueue *queue = &BSINTERNAL_CTX.eventQueue;
+    
+    bsint_b32 result = (!signal->begun || (sequence != signal->frameSequence) ||
+                        (queue->readIndex != BSInternal_LoadAcquire(&queue->writeIndex)) ||
+                        (signal->deadline && (now >= signal->deadline)) || BSINTERNAL_CTX.drawList.fullRedraw);
+    return result;
+}
+
+// NOTE(bSalmon): Non-blocking, true if an event, data change, due redraw request or invalidate came in since the last frame began
+inline bsint_b32 BS842_Imgui_NeedsRedraw()
+{
+    return BSInternal_RedrawPending(BSInternal_LoadFenced(&BSINTERNAL_CTX.redrawSignal.sequence), BSInternal_GetTimestamp());
+}
+
+// NOTE(bSalmon): Blocks the render thread until BS842_Imgui_NeedsRedraw would be true or timeoutMicroseconds passes,
+// returns which of the two it was. Wakeups that turn out to be nothing just go back to sleep
+bsint_function bsint_b32 BS842_Imgui_WaitForRedraw(bsint_u64 timeoutMicroseconds = BS842_IMGUI_WAIT_FOREVER)
+{
+    BSInternal_RedrawSignal *signal = &BSINTERNAL_CTX.redrawSignal;
+#ifdef _WIN32
+    if (!signal->event)
+    {
+        signal->event = CreateEventA(0, FALSE, FALSE, 0);
+    }
+#endif
+    
+    bsint_b32 result = false;
+    bsint_u64 start = BSInternal_GetTimestamp();
+    for (;;)
+    {
+        bsint_u32 sequence = BSInternal_LoadFenced(&signal->sequence);
+        bsint_u64 now = BSInternal_GetTimestamp();
+        if (BSInternal_RedrawPending(sequence, now))
+        {
+            result = true;
+            break;
+        }
+        
+        bsint_u64 elapsed = now - start;
+        if ((timeoutMicroseconds != BS842_IMGUI_WAIT_FOREVER) && (elapsed >= timeoutMicroseconds))
+        {
+            break;
+        }
+        
+        bsint_u64 sleepTime = (timeoutMicroseconds == BS842_IMGUI_WAIT_FOREVER) ? BS842_IMGUI_WAIT_FOREVER : timeoutMicroseconds - elapsed;
+        if (signal->deadline && ((signal->deadline - now) < sleepTime))
+        {
+            sleepTime = signal->deadline - now;
+        }
+        
+        // NOTE(bSalmon): A notifier that missed waiting being set incremented sequence first, so the sleep sees it changed
+        BSInternal_AtomicExchange(&signal->waiting, 1);
+        if (BSInternal_LoadFenced(&signal->sequence) == sequence)
+        {
+#ifdef _WIN32
+            DWORD milliseconds = (sleepTime >= ((bsint_u64)INFINITE * 1000)) ? INFINITE : (DWORD)((sleepTime + 999) / 1000);
+            WaitForSingleObject(signal->event, milliseconds);
+#elif defined(BSINTERNAL_LINUX)
+            struct timespec timeout;
+            timeout.tv_sec = (time_t)(sleepTime / 1000000);
+            timeout.tv_nsec = (long)((sleepTime % 1000000) * 1000);
+            syscall(SYS_futex, &signal->sequence, FUTEX_WAIT_PRIVATE, sequence, (sleepTime == BS842_IMGUI_WAIT_FOREVER) ? 0 : &timeout, 0, 0);
+#else
+            usleep((sleepTime < 1000) ? (useconds_t)sleepTime : 1000);
+#endif
+        }
+        BSInternal_AtomicExchange(&signal->waiting, 0);
+    }
+    
+    return result;
+}
+
+// NOTE(bSalmon): Safe to call from any number of threads while the render thread is in a frame. Returns false if the
+// queue is full, the event isn't lost, the producer should push it again later. A timestamp of 0 is filled in.
+// context is the one being fed, 0 is the producer thread's current context
+bsint_function bsint_b32 BS842_Imgui_PushEvent(BS842_ImguiEvent event, BS842_ImguiContext *context = 0)
+{
+    context = (context) ? context : bs842_internal_context;
+    BSInternal_EventQueue *queue = &context->eventQueue;
+    
+    if (!event.timestamp)
+    {
+        event.timestamp = BSInternal_GetTimestamp();
+    }
+    
+    bsint_u32 writeIndex;
+    do
+    {
+        writeIndex = BSInternal_LoadAcquire(&queue->writeIndex);
+        bsint_u32 readIndex = BSInternal_LoadAcquire(&queue->readIndex);
+        if ((writeIndex - readIndex) >= BSINTERNAL_EVENT_QUEUE_SIZE)
+        {
+            return false;
+        }
+    }
+    while (!BSInternal_AtomicCompareExchange(&queue->writeIndex, writeIndex, writeIndex + 1));
+    
+    queue->events[writeIndex & (BSINTERNAL_EVENT_QUEUE_SIZE - 1)] = event;
+    BSInternal_StoreRelease(&queue->published[writeIndex & (BSINTERNAL_EVENT_QUEUE_SIZE - 1)], writeIndex + 1);
+    BSInternal_WakeContext(context);
+    return true;
+}
+
+inline void BSInternal_PushSimpleEvent(BS842_ImguiEventType type, bsint_s32 mouseX = 0, bsint_s32 mouseY = 0, char c = 0)
+{
+    BS842_ImguiEvent event = {};
+    event.type = type;
+    event.mouseX = mouseX;
+    event.mouseY = mouseY;
+    event.c = c;
+    BS842_Imgui_PushEvent(event);
+}
+
+inline void BS842_Imgui_RegisterMouseClick(bsint_b32 down)
+{
+    if (down)
+    {
+        BSInternal_PushSimpleEvent(ImguiEvent_Click);
+    }
+}
+
+inline void BS842_Imgui_RegisterMouseMove(bsint_s32 mouseX, bsint_s32 mouseY)
+{
+    BSInternal_PushSimpleEvent(ImguiEvent_MouseMove, mouseX, mouseY);
+}
+
+inline void BS842_Imgui_RegisterMouseDoubleClick(bsint_b32 dbl)
+{
+    if (dbl)
+    {
+        BSInternal_PushSimpleEvent(ImguiEvent_DoubleClick);
+    }
+}
+
+inline void BS842_Imgui_RegisterMouseScrollUp(bsint_b32 up)
+{
+    if (up)
+    {
+        BSInternal_PushSimpleEvent(ImguiEvent_ScrollUp);
+    }
+}
+
+inline void BS842_Imgui_RegisterMouseScrollDown(bsint_b32 down)
+{
+    if (down)
+    {
+        BSInternal_PushSimpleEvent(ImguiEvent_ScrollDown);
+    }
+}
+
+// NOTE(bSalmon): Typed characters, '\b' deletes and 27 (Esc) clears the focused text field
+inline void BS842_Imgui_RegisterCharInput(char c)
+{
+    BSInternal_PushSimpleEvent(ImguiEvent_Char, 0, 0, c);
+}
+
+inline bsint_u64 BS842_Imgui_GetLastInputTimestamp()
+{
+    return BSINTERNAL_CTX.lastInputTimestamp;
+}
+
+// NOTE(bSalmon): Drains the queue in order. A frame stops after its first click so every click is tested against the
+// mouse position it happened at, anything after it is left for the next frame
+bsint_function void BS842_ImguiBegin()
+{
+#ifdef BS842_IMGUI_PROFILE
+    BS842_ImguiProfile *profile = &BSINTERNAL_CTX.profile;
+    bsint_s32 sample = profile->frameCount % BS842_IMGUI_PROFILE_FRAMES;
+    for (bsint_s32 widget = 0; widget < ProfileWidget_Count; ++widget)
+    {
+        profile->widgetNs[widget][sample] = 0;
+        profile->widgetCalls[widget][sample] = 0;
+    }
+    profile->allocationStart = BSInternal_LoadAcquire(&bs842_internal_allocationCount);
+    profile->frameStart = BSInternal_GetTimestampNs();
+#endif
+    
+    BSInternal_RedrawSignal *signal = &BSINTERNAL_CTX.redrawSignal;
+    signal->frameSequence = BSInternal_LoadFenced(&signal->sequence);
+    signal->deadline = 0;
+    signal->begun = true;
+    
+    BSInternal_EventQueue *queue = &BSINTERNAL_CTX.eventQueue;
+    
+    bsint_u32 readIndex = queue->readIndex;
+    bsint_u32 writeIndex = BSInternal_LoadAcquire(&queue->writeIndex);
+    while (readIndex != writeIndex)
+    {
+        // NOTE(bSalmon): Claimed but still being written, it and everything after it waits for the next frame
+        if (BSInternal_LoadAcquire(&queue->published[readIndex & (BSINTERNAL_EVENT_QUEUE_SIZE - 1)]) != (readIndex + 1))
+        {
+            break;
+        }
+        
+        BS842_ImguiEvent *event = &queue->events[readIndex & (BSINTERNAL_EVENT_QUEUE_SIZE - 1)];
+        if ((event->type == ImguiEvent_Char) && (BSINTERNAL_CTX.charInputCount == BSINTERNAL_MAX_CHAR_INPUT))
+        {
+            break;
+        }
+        
+        switch (event->type)
+        {
+            case ImguiEvent_MouseMove:
+            {
+                BSINTERNAL_CTX.mouseX = event->mouseX;
+                BSINTERNAL_CTX.mouseY = event->mouseY;
+            } break;
+            
+            case ImguiEvent_Click:
+            {
+                BSINTERNAL_CTX.clicked = true;
+            } break;
+            
+            case ImguiEvent_DoubleClick:
+            {
+                BSINTERNAL_CTX.dblClicked = true;
+            } break;
+            
+            case ImguiEvent_ScrollUp:
+            {
+                ++BSINTERNAL_CTX.scrolledUp;
+            } break;
+            
+            case ImguiEvent_ScrollDown:
+            {
+                ++BSINTERNAL_CTX.scrolledDown;
+            } break;
+            
+            case ImguiEvent_Char:
+            {
+                BSINTERNAL_CTX.charInput[BSINTERNAL_CTX.charInputCount++] = event->c;
+            } break;
+        }
+        
+        BSINTERNAL_CTX.lastInputTimestamp = event->timestamp;
+        ++readIndex;
+        
+        if ((event->type == ImguiEvent_Click) || (event->type == ImguiEvent_DoubleClick))
+        {
+            break;
+        }
+    }
+    
+    BSInternal_StoreRelease(&queue->readIndex, readIndex);
+    
+    BSInternal_QueryHitGrid();
+}
+
+// NOTE(bSalmon): Widgets only record draw commands, everything is rasterised into the backbuffer here
+bsint_function void BS842_ImguiEnd()
+{
+    if ((BSINTERNAL_CTX.clicked || BSINTERNAL_CTX.dblClicked) && !BSINTERNAL_CTX.clickClaimed)
+    {
+        BSINTERNAL_CTX.activeID = 0;
+    }
+    BSINTERNAL_CTX.clickClaimed = false;
+    BSINTERNAL_CTX.charInputCount = 0;
+    
+    if (BSINTERNAL_CTX.clicked)
+    {
+        BSINTERNAL_CTX.clicked = false;
+    }
+    
+    if (BSINTERNAL_CTX.dblClicked)
+    {
+        BSINTERNAL_CTX.dblClicked = false;
+    }
+    
+    BSINTERNAL_CTX.scrolledUp = 0;
+    BSINTERNAL_CTX.scrolledDown = 0;
+    
+    if (BSINTERNAL_CTX.currentID != BSINTERNAL_ROOT_ID)
+    {
+        BSINTERNAL_CTX.currentID = BSINTERNAL_ROOT_ID;
+        BSINTERNAL_CTX.idStackCount = 0;
+    }
+    BSINTERNAL_CTX.layoutStackCount = 0;
+    
+    BSINTERNAL_CTX.hotID = 0;
+    
+    if ((++BSINTERNAL_CTX.frameIndex % BSINTERNAL_STATE_EVICT_FRAMES) == 0)
+    {
+        BSInternal_EvictWidgetStates();
+    }
+    
+    BSInternal_BuildHitGrid();
+    
+#ifdef BS842_IMGUI_PROFILE
+    bsint_u64 rasterStart = BSInternal_GetTimestampNs();
+#endif
+    BSInternal_RasteriseDrawList();
+    BSInternal_ResetArena(&BSINTERNAL_CTX.frameArena);
+    
+#ifdef BS842_IMGUI_PROFILE
+    BS842_ImguiProfile *profile = &BSINTERNAL_CTX.profile;
+    bsint_s32 sample = profile->frameCount % BS842_IMGUI_PROFILE_FRAMES;
+    bsint_u64 frameEnd = BSInternal_GetTimestampNs();
+    profile->rasterNs[sample] = (bsint_u32)(frameEnd - rasterStart);
+    profile->frameNs[sample] = (bsint_u32)(frameEnd - profile->frameStart);
+    profile->allocations[sample] = BSInternal_LoadAcquire(&bs842_internal_allocationCount) - profile->allocationStart;
+    ++profile->frameCount;
+#endif
+}
+
+// NOTE(bSalmon): In retained mode the imgui owns the backbuffer between frames, it clears to clearColour itself and
+// only redraws regions that changed. Call BS842_Imgui_Invalidate if anything else draws into the backbuffer
+inline void BS842_Imgui_SetRetainedMode(bsint_b32 retained, bsint_u32 clearColour)
+{
+    BSINTERNAL_CTX.drawList.retained = retained;
+    BSINTERNAL_CTX.drawList.clearColour = clearColour;
+    BSINTERNAL_CTX.drawList.fullRedraw = true;
+}
+
+inline void BS842_Imgui_Invalidate()
+{
+    BSINTERNAL_CTX.drawList.fullRedraw = true;
+}
+
+// NOTE(bSalmon): Number of widget segments rasterised by the last BS842_ImguiEnd, 0 means the backbuffer didn't change
+inline bsint_s32 BS842_Imgui_GetRasterisedCount()
+{
+    return BSINTERNAL_CTX.drawList.rasterisedCount;
+}
+
+// NOTE(bSalmon): Segments the last BS842_ImguiEnd skipped because windows above covered them completely
+inline bsint_s32 BS842_Imgui_GetCulledCount()
+{
+    return BSINTERNAL_CTX.drawList.culledCount;
+}
+
+////////////
+// LAYOUT //
+////////////
+
+bsint_function void BSInternal_FreeLayoutCache(void *data)
+{
+    BSInternal_LayoutCache *cache = (BSInternal_LayoutCache *)data;
+    free(cache->items);
+    free(cache);
+}
+
+// NOTE(bSalmon): Items are placed one after another along a row (left to right) or a column (top to bottom) inside
+// area shrunk by padding, with spacing between them. Sizes are in pixels. Rects are cached per layout name, an
+// unchanged frame costs a hash per item, text is only measured again when it, the area or the backbuffer changes
+bsint_function void BS842_Imgui_BeginLayout(const char *name, BS842_Prim_SizeSpec area, BS842_LayoutDirection direction, bsint_s32 padding = 4, bsint_s32 spacing = 4)
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.layoutStackCount < BSINTERNAL_LAYOUT_STACK_SIZE);
+    
+    BSInternal_WidgetState *state = BSInternal_GetWidgetState(BSInternal_GetID(name));
+    if (!state->data)
+    {
+        state->data = BSINTERNAL_CALLOC(1, sizeof(BSInternal_LayoutCache));
+        state->freeData = BSInternal_FreeLayoutCache;
+    }
+    
+    BSInternal_Layout *layout = &BSINTERNAL_CTX.layoutStack[BSINTERNAL_CTX.layoutStackCount++];
+    *layout = {};
+    layout->cache = (BSInternal_LayoutCache *)state->data;
+    layout->direction = direction;
+    layout->spacing = spacing;
+    
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    layout->runningHash = BSInternal_HashBytes(BSINTERNAL_HASH_SEED, &backBuffer->width, sizeof(backBuffer->width));
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &backBuffer->height, sizeof(backBuffer->height));
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &area, sizeof(area));
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &direction, sizeof(direction));
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &padding, sizeof(padding));
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &spacing, sizeof(spacing));
+    
+    layout->inner = bs842_internal_ConvertSizeSpec(backBuffer, area);
+    layout->inner.x1 += padding;
+    layout->inner.y1 += padding;
+    layout->inner.x2 = (layout->inner.x2 - padding > layout->inner.x1) ? layout->inner.x2 - padding : layout->inner.x1;
+    layout->inner.y2 = (layout->inner.y2 - padding > layout->inner.y1) ? layout->inner.y2 - padding : layout->inner.y1;
+    layout->cursor = (direction == LayoutDirection_Row) ? layout->inner.x1 : layout->inner.y1;
+}
+
+inline void BS842_Imgui_EndLayout()
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.layoutStackCount > 0);
+    
+    BSInternal_Layout *layout = &BSINTERNAL_CTX.layoutStack[--BSINTERNAL_CTX.layoutStackCount];
+    layout->cache->itemCount = layout->itemIndex;
+}
+
+// NOTE(bSalmon): Hits when the chain of inputs up to and including this item matches last frame. A miss leaves the
+// item for the caller to resolve, everything cached after it is dropped since those chains can't match any more
+bsint_function BSInternal_LayoutItem *BSInternal_NextLayoutItem(BSInternal_Layout *layout, bsint_b32 *hit)
+{
+    BSInternal_LayoutCache *cache = layout->cache;
+    bsint_s32 index = layout->itemIndex++;
+    
+    if ((index < cache->itemCount) && (cache->items[index].inputHash == layout->runningHash))
+    {
+        *hit = true;
+        return &cache->items[index];
+    }
+    
+    if (index >= cache->itemCapacity)
+    {
+        cache->itemCapacity = (cache->itemCapacity) ? cache->itemCapacity * 2 : 16;
+        cache->items = (BSInternal_LayoutItem *)BSINTERNAL_REALLOC(cache->items, cache->itemCapacity * sizeof(BSInternal_LayoutItem));
+    }
+    cache->itemCount = index + 1;
+    cache->items[index].inputHash = layout->runningHash;
+    
+    *hit = false;
+    return &cache->items[index];
+}
+
+// NOTE(bSalmon): 0 fills what's left along the layout, or the full size across it
+bsint_function void BSInternal_ResolveLayoutItem(BSInternal_Layout *layout, BSInternal_LayoutItem *item, bsint_s32 width, bsint_s32 height)
+{
+    BSInternal_SizeSpec rect = {};
+    if (layout->direction == LayoutDirection_Row)
+    {
+        bsint_s32 remaining = (layout->inner.x2 > layout->cursor) ? layout->inner.x2 - layout->cursor : 0;
+        rect.x1 = layout->cursor;
+        rect.x2 = rect.x1 + ((width > 0) ? width : remaining);
+        rect.y1 = layout->inner.y1;
+        rect.y2 = (height > 0) ? rect.y1 + height : layout->inner.y2;
+        item->cursorAfter = rect.x2 + layout->spacing;
+    }
+    else
+    {
+        bsint_s32 remaining = (layout->inner.y2 > layout->cursor) ? layout->inner.y2 - layout->cursor : 0;
+        rect.x1 = layout->inner.x1;
+        rect.x2 = (width > 0) ? rect.x1 + width : layout->inner.x2;
+        rect.y1 = layout->cursor;
+        rect.y2 = rect.y1 + ((height > 0) ? height : remaining);
+        item->cursorAfter = rect.y2 + layout->spacing;
+    }
+    
+    bsint_f32 width_f = (bsint_f32)BSINTERNAL_CTX.backBuffer->width;
+    bsint_f32 height_f = (bsint_f32)BSINTERNAL_CTX.backBuffer->height;
+    item->rect = BS842_FillSizeSpec(rect.x1 / width_f, rect.x2 / width_f, rect.y1 / height_f, rect.y2 / height_f);
+}
+
+bsint_function BS842_Prim_SizeSpec BS842_Imgui_LayoutItem(bsint_s32 width = 0, bsint_s32 height = 0)
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.layoutStackCount > 0);
+    
+    BSInternal_Layout *layout = &BSINTERNAL_CTX.layoutStack[BSINTERNAL_CTX.layoutStackCount - 1];
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &width, sizeof(width));
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &height, sizeof(height));
+    
+    bsint_b32 hit;
+    BSInternal_LayoutItem *item = BSInternal_NextLayoutItem(layout, &hit);
+    if (!hit)
+    {
+        BSInternal_ResolveLayoutItem(layout, item, width, height);
+    }
+    
+    layout->cursor = item->cursorAfter;
+    return item->rect;
+}
+
+// NOTE(bSalmon): Sized to fit text drawn the way BS842_Button draws its label. A lineHeight of 0 fits the text to
+// the height of a row, items in a column need a lineHeight
+bsint_function BS842_Prim_SizeSpec BS842_Imgui_LayoutText(const char *text, bsint_f32 lineHeight = 0.0f)
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.layoutStackCount > 0);
+    
+    BSInternal_Layout *layout = &BSINTERNAL_CTX.layoutStack[BSINTERNAL_CTX.layoutStackCount - 1];
+    INTERNAL_ASSERT((lineHeight > 0.0f) || (layout->direction == LayoutDirection_Row));
+    
+    bsint_s32 textLength = bs842_internal_StringLength(text);
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, text, textLength);
+    layout->runningHash = BSInternal_HashBytes(layout->runningHash, &lineHeight, sizeof(lineHeight));
+    
+    bsint_b32 hit;
+    BSInternal_LayoutItem *item = BSInternal_NextLayoutItem(layout, &hit);
+    if (!hit)
+    {
+        bsint_s32 height = 0;
+        if (lineHeight <= 0.0f)
+        {
+            lineHeight = (bsint_f32)(bsint_s32)((layout->inner.y2 - layout->inner.y1) * 0.9f);
+        }
+        else
+        {
+            height = (bsint_s32)(lineHeight / 0.9f) + 1;
+        }
+        
+        bsint_s32 extentX = 0;
+        BS842_MeasureText(&BSINTERNAL_CTX.fontInfo, text, textLength, lineHeight, &extentX);
+        bsint_s32 textInset = bs842_prim_internal_RoundF32ToS32(0.0025f * BSINTERNAL_CTX.backBuffer->width);
+        BSInternal_ResolveLayoutItem(layout, item, extentX + (textInset * 2), height);
+    }
+    
+    layout->cursor = item->cursorAfter;
+    return item->rect;
+}
+
+bsint_function BS842_Prim_SizeSpec BS842_MenuBar()
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_MenuBar);
+    BSInternal_BeginWidget();
+    
+    BS842_Prim_SizeSpec result = BS842_FillSizeSpec(0.0f, 1.0f, 0.0f, 0.04f);
+    
+    BS842_Prim_SizeSpec boxSizeSpec = result;
+    BS842_Prim_SizeSpec lineSizeSpec = BS842_FillSizeSpec(result.x1, result.x2, result.y2, result.y2);
+    BSInternal_PushSolidBox(boxSizeSpec, BSINTERNAL_CTX.theme.menuBarBackground);
+    BSInternal_PushLine(lineSizeSpec, 3.0f, BSINTERNAL_CTX.theme.elemOutline);
+    
+    BSINTERNAL_PROFILE_END(ProfileWidget_MenuBar);
+    BSInternal_EndWidget();
+    
+    return result;
+}
+
+bsint_function bsint_b32 BS842_MenuBarItem(BS842_Prim_SizeSpec menuBarSizeSpec, bsint_s32 menuItemOrder, char *title, bsint_b32 *hasBeenClicked, BS842_Prim_SizeSpec *childAnchor = 0)
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_MenuBarItem);
+    BSInternal_BeginWidget();
+    BS842_ImguiID id = BSInternal_GetID(title);
+    
+    bsint_b32 result = false;
+    
+    bsint_f32 itemWidth = 0.1f;
+    bsint_f32 itemLeft = ((bsint_f32)menuItemOrder * itemWidth) + 0.0075f;
+    BS842_Prim_SizeSpec sizeSpec = BS842_FillSizeSpec(itemLeft, itemLeft + itemWidth, menuBarSizeSpec.y1, menuBarSizeSpec.y2 - 0.004f);
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
+    
+    bsint_b32 hovered = BSInternal_HitTest(id, int_sizeSpec);
+    
+    if (hovered)
+    {
+        BSInternal_PushSolidBox(sizeSpec, BSINTERNAL_CTX.theme.menuItemHovered);
+        if (BSINTERNAL_CTX.clicked)
+        {
+            *hasBeenClicked = true;
+        }
+    }
+    else
+    {
+        BSInternal_PushSolidBox(sizeSpec, BSINTERNAL_CTX.theme.menuBarBackground);
+        *hasBeenClicked = false;
+    }
+    
+    BSInternal_PushLine(BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x1, sizeSpec.y1, sizeSpec.y2), 1.0f, BSINTERNAL_CTX.theme.menuItemBorder);
+    BSInternal_PushLine(BS842_FillSizeSpec(sizeSpec.x2, sizeSpec.x2, sizeSpec.y1, sizeSpec.y2), 1.0f, BSINTERNAL_CTX.theme.menuItemBorder);
+    
+    bsint_s32 textSizeY = (bsint_s32)(((sizeSpec.y2 - sizeSpec.y1) * BSINTERNAL_CTX.backBuffer->height) * 0.9f);
+    BSInternal_PushText(&BSINTERNAL_CTX.fontInfo, title, -1, (bsint_f32)textSizeY, BSINTERNAL_CTX.theme.defaultText, sizeSpec.x1 + 0.0025f, sizeSpec.y1 + 0.0025f);
+    
+    if (childAnchor)
+    {
+        *childAnchor = BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x1, sizeSpec.y2, sizeSpec.y2);
+    }
+    
+    if (*hasBeenClicked)
+    {
+        result = true;
+        }
+        
+    BSINTERNAL_PROFILE_END(ProfileWidget_MenuBarItem);
+    BSInternal_EndWidget();
+    
+    return result;
+}
+
+struct BSInternal_StringView
+{
+    bsint_s32 offset;
+    bsint_s32 length;
+};
+
+// NOTE(bSalmon): Steps through text a line at a time without copying it, the view leaves out the '\n'. Text ending
+// in '\n' still gives the empty line after it, same as the text box has always drawn
+inline bsint_b32 BSInternal_NextLine(char *text, bsint_s32 textLength, bsint_s32 *cursor, BSInternal_StringView *line)
+{
+    if (*cursor > textLength)
+    {
+        return false;
+    }
+    
+    line->offset = *cursor;
+    line->length = 0;
+    while (((line->offset + line->length) < textLength) && (text[line->offset + line->length] != '\n'))
+    {
+        ++line->length;
+    }
+    
+    *cursor = line->offset + line->length + 1;
+    return true;
+}
+
+bsint_function void BS842_TextBox(BS842_Prim_SizeSpec *anchor, char *text, bsint_f32 fontLineHeight = 5.0f, bsint_f32 xPos = 0.0f, bsint_f32 yPos = 0.0f)
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_TextBox);
+    BSInternal_BeginWidget();
+    
+    // NOTE(bSalmon): One copy of the whole text for the draw list, every line is drawn from a view into it
+    bsint_s32 strLen = bs842_internal_StringLength(text);
+    char *frameText = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, strLen + 1, char);
+    bs842_internal_CopyMem(frameText, text, strLen);
+    frameText[strLen] = '\0';
+    
+    bsint_s32 lineCount = 0;
+    bsint_s32 longestStringCharCount = 1;
+    BSInternal_StringView line;
+    for (bsint_s32 cursor = 0; BSInternal_NextLine(frameText, strLen, &cursor, &line);)
+    {
+        ++lineCount;
+        if ((line.length + 1) > longestStringCharCount)
+        {
+            longestStringCharCount = line.length + 1;
+        }
+    }
+    
+    if (anchor)
+    {
+        xPos = anchor->x1;
+        yPos = anchor->y2;
+    }
+        
+        bsint_f32 yCursor = yPos + 0.005f;
+    bsint_s32 textSizeY = fontLineHeight; // TODO(bSalmon): Convert to scale with window size
+        
+        bsint_s32 xPosS = bs842_prim_internal_RoundF32ToS32(xPos * BSINTERNAL_CTX.backBuffer->width);
+        xPosS = (xPosS < 0) ? 0 : ((xPosS > BSINTERNAL_CTX.backBuffer->width) ? BSINTERNAL_CTX.backBuffer->width : xPosS);
+        bsint_s32 yPosS = bs842_prim_internal_RoundF32ToS32(yPos * BSINTERNAL_CTX.backBuffer->height);
+        yPosS = (yPosS < 0) ? 0 : ((yPosS > BSINTERNAL_CTX.backBuffer->width) ? BSINTERNAL_CTX.backBuffer->height : yPosS);
+        
+        bsint_s32 boxBottom = yPosS + ((textSizeY + (bsint_s32)(0.005f * BSINTERNAL_CTX.backBuffer->height)) * lineCount) + (bsint_s32)(0.01f * BSINTERNAL_CTX.backBuffer->height);
+        bsint_s32 boxRight = xPosS + ((bsint_s32)(textSizeY * 0.5f) * longestStringCharCount);
+        
+        BSInternal_SizeSpec sizeSpec = BS842_FillSizeSpec(xPosS, boxRight, yPosS, boxBottom);
+        BSInternal_PushOutlinedBox(sizeSpec, 1.0f, BSINTERNAL_CTX.theme.elemBackground, BSINTERNAL_CTX.theme.elemOutline);
+        
+        for (bsint_s32 cursor = 0; BSInternal_NextLine(frameText, strLen, &cursor, &line);)
+        {
+            if (line.length)
+            {
+                BSInternal_PushTextView(&BSINTERNAL_CTX.fontInfo, frameText + line.offset, line.length, fontLineHeight, BSINTERNAL_CTX.theme.defaultText, xPos + 0.005f, yCursor);
+            }
+            
+            yCursor += (fontLineHeight / BSINTERNAL_CTX.backBuffer->height) + 0.005f;
+        }
+    
+    BSINTERNAL_PROFILE_END(ProfileWidget_TextBox);
+    BSInternal_EndWidget();
+}
+
+bsint_function void BSInternal_DrawBasicWindow(char *title, BS842_Prim_SizeSpec sizeSpec)
+{
+    bsint_f32 titleBarRatio = 0.05f;
+    BSInternal_PushSolidBox(BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x2, sizeSpec.y1, sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * titleBarRatio)), BSINTERNAL_CTX.theme.menuBarBackground);
+    BSInternal_PushSolidBox(BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x2, sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * titleBarRatio), sizeSpec.y2), BSINTERNAL_CTX.theme.elemBackground);
+    BSInternal_PushHollowBox(sizeSpec, 2.0f, BSINTERNAL_CTX.theme.elemOutline);
+    
+    BS842_Prim_SizeSpec textSizeSpec = BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x2, sizeSpec.y1, sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * titleBarRatio));
+    bsint_s32 textSizeY = (bsint_s32)(((textSizeSpec.y2 - textSizeSpec.y1) * BSINTERNAL_CTX.backBuffer->height) * 0.9f);
+    BSInternal_PushText(&BSINTERNAL_CTX.fontInfo, title, -1, (bsint_f32)textSizeY, BSINTERNAL_CTX.theme.defaultText, sizeSpec.x1 + 0.0025f, sizeSpec.y1 + 0.0025f);
+}
+
+bsint_function void BSInternal_FreePanelCache(void *data)
+{
+    BSInternal_PanelCache *panel = (BSInternal_PanelCache *)data;
+    free(panel->runs);
+    free(panel->pixels);
+    free(panel);
+}
+
+// NOTE(bSalmon): Rasterises the chrome segment over two different clear colours. Pixels that come out the same both times
+// are the chrome's own, pixels that kept the clear colour both times are left alone, anything else blended with what was
+// under it and can't be reused, so the panel is marked uncacheable and drawn normally
+bsint_function void BSInternal_CapturePanel(BSInternal_PanelCache *panel, BSInternal_DrawSegment *segment)
+{
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    
+    free(panel->runs);
+    free(panel->pixels);
+    panel->runs = 0;
+    panel->runCount = 0;
+    panel->pixels = 0;
+    panel->uncacheable = false;
+    
+    BSInternal_SizeSpec bounds = segment->bounds;
+    bounds.x1 = (bounds.x1 < 0) ? 0 : bounds.x1;
+    bounds.y1 = (bounds.y1 < 0) ? 0 : bounds.y1;
+    bounds.x2 = (bounds.x2 >= backBuffer->width) ? backBuffer->width - 1 : bounds.x2;
+    bounds.y2 = (bounds.y2 >= backBuffer->height) ? backBuffer->height - 1 : bounds.y2;
+    panel->bounds = bounds;
+    if ((bounds.x1 > bounds.x2) || (bounds.y1 > bounds.y2))
+    {
+        return;
+    }
+    
+    bsint_s32 boundsWidth = (bounds.x2 - bounds.x1) + 1;
+    bsint_s32 boundsHeight = (bounds.y2 - bounds.y1) + 1;
+    bsint_mem_index scratchSize = (bsint_mem_index)backBuffer->pitch * backBuffer->height;
+    
+    BSInternal_BackBuffer scratch = *backBuffer;
+    scratch.memory = BSINTERNAL_MALLOC(scratchSize);
+    bsint_u32 *firstPass = (bsint_u32 *)BSINTERNAL_MALLOC(boundsWidth * boundsHeight * sizeof(bsint_u32));
+    
+    bsint_u32 clearColours[2] = {0x00000000, 0xFFFFFFFF};
+    BSINTERNAL_CTX.backBuffer = &scratch;
+    for (bsint_s32 pass = 0; pass < 2; ++pass)
+    {
+        for (bsint_s32 y = bounds.y1; y <= bounds.y2; ++y)
+        {
+            bsint_u32 *row = (bsint_u32 *)((bsint_u8 *)scratch.memory + (y * scratch.pitch));
+            for (bsint_s32 x = bounds.x1; x <= bounds.x2; ++x)
+            {
+                row[x] = clearColours[pass];
+            }
+        }
+        
+        BSInternal_RasteriseSegment(segment, 0, 0);
+        if (BSINTERNAL_CTX.textBatch.itemCount)
+        {
+            BS842_TextBatchFlush(&scratch, &BSINTERNAL_CTX.textBatch);
+        }
+        
+        for (bsint_s32 y = bounds.y1; (pass == 0) && (y <= bounds.y2); ++y)
+        {
+            bsint_u32 *row = (bsint_u32 *)((bsint_u8 *)scratch.memory + (y * scratch.pitch));
+            bs842_internal_CopyMem(firstPass + ((y - bounds.y1) * boundsWidth), row + bounds.x1, boundsWidth * sizeof(bsint_u32));
+        }
+    }
+    BSINTERNAL_CTX.backBuffer = backBuffer;
+    
+    // NOTE(bSalmon): Pixels are packed in place over the first pass, a run never starts ahead of where it's read from
+    bsint_s32 runCapacity = 0;
+    bsint_s32 pixelCount = 0;
+    for (bsint_s32 y = bounds.y1; !panel->uncacheable && (y <= bounds.y2); ++y)
+    {
+        bsint_u32 *first = firstPass + ((y - bounds.y1) * boundsWidth);
+        bsint_u32 *second = (bsint_u32 *)((bsint_u8 *)scratch.memory + (y * scratch.pitch)) + bounds.x1;
+        BSInternal_PanelRun *run = 0;
+        for (bsint_s32 x = 0; x < boundsWidth; ++x)
+        {
+            if (first[x] == second[x])
+            {
+                if (!run)
+                {
+                    if (panel->runCount == runCapacity)
+                    {
+                        runCapacity = (runCapacity) ? runCapacity * 2 : 64;
+                        panel->runs = (BSInternal_PanelRun *)BSINTERNAL_REALLOC(panel->runs, runCapacity * sizeof(BSInternal_PanelRun));
+                    }
+                    run = &panel->runs[panel->runCount++];
+                    run->x = bounds.x1 + x;
+                    run->y = y;
+                    run->length = 0;
+                    run->offset = pixelCount;
+                }
+                firstPass[pixelCount++] = first[x];
+                ++run->length;
+            }
+            else if ((first[x] == clearColours[0]) && (second[x] == clearColours[1]))
+            {
+                run = 0;
+            }
+            else
+            {
+                panel->uncacheable = true;
+                break;
+            }
+        }
+    }
+    
+    free(scratch.memory);
+    if (panel->uncacheable)
+    {
+        free(firstPass);
+        free(panel->runs);
+        panel->runs = 0;
+        panel->runCount = 0;
+    }
+    else
+    {
+        panel->pixels = (bsint_u32 *)BSINTERNAL_REALLOC(firstPass, (pixelCount) ? pixelCount * sizeof(bsint_u32) : 1);
+    }
+}
+
+// NOTE(bSalmon): The chrome is keyed on the window's pixel rect, the backbuffer size, the theme and the title. A hit
+// replaces the chrome's draw commands with one copy of the captured pixels
+bsint_function void BSInternal_DrawCachedWindow(char *title, BS842_Prim_SizeSpec sizeSpec)
+{
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    BSInternal_DrawList *drawList = &BSINTERNAL_CTX.drawList;
+    
+    BSInternal_WidgetState *state = BSInternal_GetWidgetState(BSInternal_GetID("##Panel"));
+    if (!state->data)
+    {
+        state->data = BSINTERNAL_CALLOC(1, sizeof(BSInternal_PanelCache));
+        state->freeData = BSInternal_FreePanelCache;
+    }
+    BSInternal_PanelCache *panel = (BSInternal_PanelCache *)state->data;
+    
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(backBuffer, sizeSpec);
+    bsint_u32 key = BSINTERNAL_HASH_SEED;
+    key = BSInternal_HashBytes(key, &int_sizeSpec, sizeof(int_sizeSpec));
+    key = BSInternal_HashBytes(key, &backBuffer->width, sizeof(backBuffer->width));
+    key = BSInternal_HashBytes(key, &backBuffer->height, sizeof(backBuffer->height));
+    key = BSInternal_HashBytes(key, &BSINTERNAL_CTX.theme, sizeof(BSINTERNAL_CTX.theme));
+    key = BSInternal_HashBytes(key, title, bs842_internal_StringLength(title));
+    
+    if (panel->key != key)
+    {
+        bsint_s32 segmentIndex = drawList->segmentCount;
+        BSInternal_BeginWidget();
+        BSInternal_DrawBasicWindow(title, sizeSpec);
+        BSInternal_CapturePanel(panel, &drawList->segments[segmentIndex]);
+        panel->key = key;
+        
+        drawList->segmentCount = segmentIndex;
+        drawList->segmentOpen = false;
+    }
+    
+    if (panel->uncacheable)
+    {
+        BSInternal_DrawBasicWindow(title, sizeSpec);
+    }
+    else
+    {
+        BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_Panel, panel->bounds);
+        command->panel = panel;
+        BSInternal_HashDrawCommand(command);
+    }
+}
+
+// NOTE(bSalmon): Window chrome is captured once and copied back each frame instead of being drawn from primitives.
+// Only worth it while windows keep their size and place, any change captures the chrome again
+inline void BS842_Imgui_SetPanelCaching(bsint_b32 enabled)
+{
+    BSINTERNAL_CTX.panelCaching = enabled;
+}
+
+// NOTE(bSalmon): Everything up to BS842_Imgui_EndWindow belongs to the window and is composited with it, windows
+// draw over anything outside a window that came before the first of them, and under anything that came after.
+// Also pushes title as an ID scope. Windows don't nest
+bsint_function void BS842_Imgui_BeginWindow(char *title, BS842_Prim_SizeSpec sizeSpec)
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_Window);
+    INTERNAL_ASSERT(!BSINTERNAL_CTX.currentWindow);
+    INTERNAL_ASSERT(BSINTERNAL_CTX.windowCount < BSINTERNAL_MAX_WINDOWS);
+    
+    BSInternal_BeginWidget();
+    BS842_ImguiID id = BSInternal_GetID(title);
+    BSInternal_WidgetState *state = BSInternal_GetWidgetState(id);
+    if (!state->zOrder || ((BSINTERNAL_CTX.clicked || BSINTERNAL_CTX.dblClicked) && (BSINTERNAL_CTX.hitGrid.hoveredWindowID == id)))
+    {
+        state->zOrder = ((state->zOrder) && (state->zOrder == BSINTERNAL_CTX.windowTopZ)) ? state->zOrder : ++BSINTERNAL_CTX.windowTopZ;
+    }
+    
+    // NOTE(bSalmon): The solid fills of a basic window cover x1 up to but not including x2
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
+    BSInternal_Window *window = &BSINTERNAL_CTX.windows[BSINTERNAL_CTX.windowCount++];
+    window->id = id;
+    window->rect = BS842_FillSizeSpec(int_sizeSpec.x1, int_sizeSpec.x2 - 1, int_sizeSpec.y1, int_sizeSpec.y2);
+    window->zOrder = state->zOrder;
+    BSINTERNAL_CTX.currentWindow = BSINTERNAL_CTX.windowCount;
+    
+    BSInternal_HitTest(id, int_sizeSpec);
+    BS842_Imgui_PushID(title);
+    if (BSINTERNAL_CTX.panelCaching)
+    {
+        BSInternal_DrawCachedWindow(title, sizeSpec);
+    }
+    else
+    {
+        BSInternal_DrawBasicWindow(title, sizeSpec);
+    }
+    BSINTERNAL_PROFILE_END(ProfileWidget_Window);
+}
+
+inline void BS842_Imgui_EndWindow()
+{
+    INTERNAL_ASSERT(BSINTERNAL_CTX.currentWindow);
+    
+    BS842_Imgui_PopID();
+    BSInternal_EndWidget();
+    BSINTERNAL_CTX.currentWindow = 0;
+}
+
+bsint_function bsint_b32 BS842_Button(BS842_Prim_SizeSpec anchor, const char *label)
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_Button);
+    BSInternal_BeginWidget();
+    BS842_ImguiID id = BSInternal_GetID(label);
+    
+    bsint_b32 result = false;
+    
+    BS842_Prim_SizeSpec sizeSpec = anchor;
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
+    
+    bsint_b32 hovered = BSInternal_HitTest(id, int_sizeSpec);
+    
+    if (hovered)
+    {
+        BSInternal_PushOutlinedBox(sizeSpec, 2.0f, BSINTERNAL_CTX.theme.menuItemHovered, BSINTERNAL_CTX.theme.menuItemHovered);
+        if (BSINTERNAL_CTX.clicked)
+        {
+             result = true;
+        }
+    }
+    else
+    {
+        BSInternal_PushOutlinedBox(sizeSpec, 2.0f, BSINTERNAL_CTX.theme.menuBarBackground, BSINTERNAL_CTX.theme.menuItemHovered);
+    }
+    
+    bsint_s32 textSizeY = (bsint_s32)(((sizeSpec.y2 - sizeSpec.y1) * BSINTERNAL_CTX.backBuffer->height) * 0.9f);
+    BSInternal_PushText(&BSINTERNAL_CTX.fontInfo, label, -1, (bsint_f32)textSizeY, BSINTERNAL_CTX.theme.defaultText, sizeSpec.x1 + 0.0025f, sizeSpec.y1 + 0.0025f);
+    
+    BSINTERNAL_PROFILE_END(ProfileWidget_Button);
+    BSInternal_EndWidget();
+    
+    return result;
+}
+
+struct BS842_Imgui_FileInfo
+{
+    char filename[MAX_PATH];
+    char currFolder[MAX_PATH];
+    bsint_s32 currFolderLength;
+    bsint_b32 hasBeenRead;
+};
+
+enum BSInternal_FindResultType
+{
+    FindResult_Folder,
+    FindResult_File,
+};
+
+// NOTE(bSalmon): The browser enumerates a folder once and keeps the listing until the folder or file types change, or the
+// OS reports a change in the folder (inotify on Linux, change notifications on Win32). A watcher thread waits on the OS and
+// wakes the UI, so an idle browser doesn't poll. Other platforms only refresh on navigation or BS842_Imgui_RefreshFileBrowser
+#define BSINTERNAL_MAX_FILE_TYPES_LENGTH 64
+#define BSINTERNAL_MAX_EXTENSIONS 16
+#define BSINTERNAL_MAX_EXTENSION_LENGTH 16
+#define BSINTERNAL_FOLDER_POLL_MICROSECONDS 500000
+
+struct BSInternal_DirEntry
+{
+    bsint_s32 nameOffset;
+    BSInternal_FindResultType type;
+};
+
+struct BSInternal_DirEntryArray
+{
+    BSInternal_DirEntry *entries;
+    bsint_s32 entryCount;
+    bsint_s32 entryCapacity;
+    
+    char *names;
+    bsint_s32 namesUsed;
+    bsint_s32 namesCapacity;
+};
+
+// NOTE(bSalmon): Built once per listing: a lowercased copy of the names (same offsets as the entry array), a mask of the
+// character classes in each name and, for every trigram bucket, the ascending list of entries containing it. A query
+// looks up its rarest trigram and only checks the entries in that bucket, and the masks reject most of those (or all
+// entries for queries shorter than a trigram) without touching the names
+#define BSINTERNAL_TRIGRAM_BUCKET_BITS 14
+#define BSINTERNAL_TRIGRAM_BUCKETS (1 << BSINTERNAL_TRIGRAM_BUCKET_BITS)
+#define BSINTERNAL_MAX_FILTER_LENGTH 64
+
+struct BSInternal_FilterIndex
+{
+    bsint_b32 built;
+    char *lowerNames;
+    bsint_s32 lowerNamesCapacity;
+    
+    bsint_u32 *charMasks;
+    bsint_s32 charMasksCapacity;
+    
+    bsint_s32 *bucketStart;
+    bsint_s32 *postings;
+    bsint_s32 postingsCapacity;
+};
+
+struct BSInternal_FilterState
+{
+    char query[BSINTERNAL_MAX_FILTER_LENGTH];
+    bsint_s32 queryLength;
+    
+    // NOTE(bSalmon): The query and listing generation the matches were computed for
+    char matchedQuery[BSINTERNAL_MAX_FILTER_LENGTH];
+    bsint_s32 matchedQueryLength;
+    bsint_u32 matchedGeneration;
+    bsint_b32 matchesValid;
+    
+    bsint_s32 *matches;
+    bsint_s32 matchCount;
+    bsint_s32 matchCapacity;
+};
+
+// NOTE(bSalmon): fileTypes is a list of suffixes separated by ';', ',', '|' or spaces, e.g. ".ibt;.csv" or "*.ibt *.csv".
+// An empty list, "*" or "*.*" matches every file. Matching is case-insensitive, and the last character of each suffix
+// goes in a bitmask so most names are rejected with a single lookup
+struct BSInternal_ExtensionMatcher
+{
+    char extensions[BSINTERNAL_MAX_EXTENSIONS][BSINTERNAL_MAX_EXTENSION_LENGTH];
+    bsint_s32 lengths[BSINTERNAL_MAX_EXTENSIONS];
+    bsint_s32 count;
+    bsint_b32 matchAll;
+    bsint_u32 lastCharMask[8];
+};
+
+#if defined(BSINTERNAL_LINUX)
+// NOTE(bSalmon): One per enumeration. The listing frees it once the worker is done, or a cancelled worker frees it itself
+struct BSInternal_DirEnumJob
+{
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    
+    // NOTE(bSalmon): Shared with the worker, only touched with the mutex held
+    bsint_b32 cancel;
+    bsint_b32 done;
+    BSInternal_DirEntryArray pending;
+    
+    // NOTE(bSalmon): Owned by the worker until done is set, then swapped into the listing
+    BSInternal_DirEntryArray complete;
+    BSInternal_FilterIndex completeIndex;
+    
+    // NOTE(bSalmon): Copied in before the worker starts, read-only afterwards. context is woken whenever there's more
+    char folder[MAX_PATH];
+    BSInternal_ExtensionMatcher matcher;
+    BS842_ImguiContext *context;
+};
+#endif
+
+struct BSInternal_DirListing
+{
+    char folder[MAX_PATH];
+    char fileTypes[BSINTERNAL_MAX_FILE_TYPES_LENGTH];
+    bsint_b32 valid;
+    bsint_b32 loading;
+    bsint_b32 progressive;
+    
+    BSInternal_ExtensionMatcher matcher;
+    BSInternal_DirEntryArray array;
+    bsint_u32 generation;
+    
+    BSInternal_FilterIndex index;
+    BSInternal_FilterState filter;
+    
+    // NOTE(bSalmon): The watcher thread waits on the OS notification, sets folderChanged and wakes context. It's stopped
+    // before the listing is freed, which happens before the context is
+    BS842_ImguiContext *context;
+    bsint_b32 watching;
+    volatile bsint_u32 folderChanged;
+    
+#ifdef _WIN32
+    HANDLE changeHandle;
+    HANDLE watchThread;
+    HANDLE watchStopEvent;
+#elif defined(BSINTERNAL_LINUX)
+    int inotifyFD;
+    int watchDescriptor;
+    
+    pthread_t watchThread;
+    int watchStopFD;
+    
+    BSInternal_DirEnumJob *job;
+#endif
+};
+
+bsint_function void BSInternal_AddDirEntry(BSInternal_DirEntryArray *array, char *name, bsint_s32 nameLength, BSInternal_FindResultType type)
+{
+    if (array->entryCount == array->entryCapacity)
+    {
+        array->entryCapacity = (array->entryCapacity) ? array->entryCapacity * 2 : 256;
+        array->entries = (BSInternal_DirEntry *)BSINTERNAL_REALLOC(array->entries, array->entryCapacity * sizeof(BSInternal_DirEntry));
+    }
+    
+    if (array->namesUsed + nameLength + 1 > array->namesCapacity)
+    {
+        array->namesCapacity = (array->namesCapacity) ? array->namesCapacity * 2 : 8192;
+        while (array->namesUsed + nameLength + 1 > array->namesCapacity)
+        {
+            array->namesCapacity *= 2;
+        }
+        array->names = (char *)BSINTERNAL_REALLOC(array->names, array->namesCapacity);
+    }
+    
+    BSInternal_DirEntry *entry = &array->entries[array->entryCount++];
+    entry->nameOffset = array->namesUsed;
+    entry->type = type;
+    
+    bs842_internal_CopyMem(array->names + array->namesUsed, name, nameLength);
+    array->names[array->namesUsed + nameLength] = '\0';
+    array->namesUsed += nameLength + 1;
+}
+
+bsint_function void BSInternal_AppendDirEntries(BSInternal_DirEntryArray *dest, BSInternal_DirEntryArray *src)
+{
+    for (bsint_s32 entryIndex = 0; entryIndex < src->entryCount; ++entryIndex)
+    {
+        char *name = src->names + src->entries[entryIndex].nameOffset;
+        BSInternal_AddDirEntry(dest, name, bs842_internal_StringLength(name), src->entries[entryIndex].type);
+    }
+}
+
+inline void BSInternal_ClearDirEntries(BSInternal_DirEntryArray *array)
+{
+    array->entryCount = 0;
+    array->namesUsed = 0;
+}
+
+inline void BSInternal_FreeDirEntries(BSInternal_DirEntryArray *array)
+{
+    free(array->entries);
+    free(array->names);
+    *array = {};
+}
+
+inline bsint_b32 BSInternal_IsDigit(char c)
+{
+    return ((c >= '0') && (c <= '9'));
+}
+
+inline char BSInternal_ToLower(char c)
+{
+    return ((c >= 'A') && (c <= 'Z')) ? (c + ('a' - 'A')) : c;
+}
+
+bsint_function void BSInternal_CompileExtensionMatcher(BSInternal_ExtensionMatcher *matcher, char *fileTypes)
+{
+    *matcher = {};
+    
+    char *scan = fileTypes;
+    while (*scan)
+    {
+        while ((*scan == ';') || (*scan == ',') || (*scan == '|') || (*scan == ' ') || (*scan == '*'))
+        {
+            ++scan;
+        }
+        
+        bsint_s32 length = 0;
+        while (scan[length] && (scan[length] != ';') && (scan[length] != ',') && (scan[length] != '|') && (scan[length] != ' '))
+        {
+            ++length;
+        }
+        
+        if ((length == 2) && (scan[0] == '.') && (scan[1] == '*'))
+        {
+            matcher->matchAll = true;
+        }
+        else if ((length > 0) && (length < BSINTERNAL_MAX_EXTENSION_LENGTH) && (matcher->count < BSINTERNAL_MAX_EXTENSIONS))
+        {
+            for (bsint_s32 charIndex = 0; charIndex < length; ++charIndex)
+            {
+                matcher->extensions[matcher->count][charIndex] = BSInternal_ToLower(scan[charIndex]);
+            }
+            matcher->lengths[matcher->count] = length;
+            
+            bsint_u8 lastChar = (bsint_u8)matcher->extensions[matcher->count][length - 1];
+            matcher->lastCharMask[lastChar >> 5] |= (1u << (lastChar & 31));
+            ++matcher->count;
+        }
+        
+        scan += length;
+    }
+    
+    matcher->matchAll = (matcher->matchAll || (matcher->count == 0));
+}
+
+inline bsint_b32 BSInternal_MatchesExtension(BSInternal_ExtensionMatcher *matcher, char *filename, bsint_s32 filenameLength)
+{
+    if (matcher->matchAll)
+    {
+        return true;
+    }
+    
+    if (filenameLength == 0)
+    {
+        return false;
+    }
+    
+    bsint_u8 lastChar = (bsint_u8)BSInternal_ToLower(filename[filenameLength - 1]);
+    if (!(matcher->lastCharMask[lastChar >> 5] & (1u << (lastChar & 31))))
+    {
+        return false;
+    }
+    
+    for (bsint_s32 extIndex = 0; extIndex < matcher->count; ++extIndex)
+    {
+        bsint_s32 extLength = matcher->lengths[extIndex];
+        if (filenameLength >= extLength)
+        {
+            char *suffix = &filename[filenameLength - extLength];
+            bsint_b32 matched = true;
+            for (bsint_s32 charIndex = 0; charIndex < extLength; ++charIndex)
+            {
+                if (BSInternal_ToLower(suffix[charIndex]) != matcher->extensions[extIndex][charIndex])
+                {
+                    matched = false;
+                    break;
+                }
+            }
+            
+            if (matched)
+            {
+                return true;
+            }
+        }
+    }
+    
+    return false;
 }
 
-inline void BS842_Imgui_RegisterMouseScrollUp(bsint_b32 up)
+bsint_function void BSInternal_UnwatchFolder(BSInternal_DirListing *listing)
 {
-    bs842_internal_info.scrolledUp = up;
+#ifdef _WIN32
+    if (listing->changeHandle && (listing->changeHandle != INVALID_HANDLE_VALUE))
+    {
+        FindCloseChangeNotification(listing->changeHandle);
+    }
+    listing->changeHandle = 0;
+#elif defined(BSINTERNAL_LINUX)
+    if ((listing->inotifyFD > 0) && (listing->watchDescriptor >= 0))
+    {
+        inotify_rm_watch(listing->inotifyFD, listing->watchDescriptor);
+    }
+    BSInternal_StoreRelease((volatile bsint_u32 *)&listing->watchDescriptor, (bsint_u32)-1);
+#endif
 }
 
-inline void BS842_Imgui_RegisterMouseScrollDown(bsint_b32 down)
+#ifdef _WIN32
+// NOTE(bSalmon): Sleeps until the folder changes or the listing stops watching, so the render thread only checks a flag
+bsint_function DWORD WINAPI BSInternal_FolderWatchWorker(void *param)
 {
-    bs842_internal_info.scrolledDown = down;
+    BSInternal_DirListing *listing = (BSInternal_DirListing *)param;
+    
+    HANDLE waitHandles[2] = {listing->watchStopEvent, listing->changeHandle};
+    while (WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE) == (WAIT_OBJECT_0 + 1))
+    {
+        BSInternal_StoreRelease(&listing->folderChanged, 1);
+        BSInternal_WakeContext(listing->context);
+        
+        if (!FindNextChangeNotification(listing->changeHandle))
+        {
+            break;
+        }
+    }
+    
+    return 0;
 }
 
-bsint_function void BS842_ImguiBegin() {}
-bsint_function void BS842_ImguiEnd()
+bsint_function void BSInternal_StopFolderWatcher(BSInternal_DirListing *listing)
+{
+    if (listing->watching)
+    {
+        SetEvent(listing->watchStopEvent);
+        WaitForSingleObject(listing->watchThread, INFINITE);
+        CloseHandle(listing->watchThread);
+        listing->watchThread = 0;
+        listing->watching = false;
+    }
+    
+    if (listing->watchStopEvent)
+    {
+        CloseHandle(listing->watchStopEvent);
+        listing->watchStopEvent = 0;
+    }
+}
+#elif defined(BSINTERNAL_LINUX)
+// NOTE(bSalmon): Drains the (non-blocking) inotify descriptor, true if anything happened to the current watch
+bsint_function bsint_b32 BSInternal_ReadFolderEvents(BSInternal_DirListing *listing)
+{
+    bsint_b32 result = false;
+    
+    // NOTE(bSalmon): Removed watches still post IN_IGNORED to the descriptor, so only events for the current watch count
+    int watchDescriptor = (int)BSInternal_LoadAcquire((volatile bsint_u32 *)&listing->watchDescriptor);
+    char eventBuffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (long bytesRead = read(listing->inotifyFD, eventBuffer, sizeof(eventBuffer)); bytesRead > 0;
+         bytesRead = read(listing->inotifyFD, eventBuffer, sizeof(eventBuffer)))
+    {
+        for (long offset = 0; offset < bytesRead;)
+        {
+            struct inotify_event *event = (struct inotify_event *)(eventBuffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+            
+            if (((event->wd == watchDescriptor) && !(event->mask & IN_IGNORED)) || (event->mask & IN_Q_OVERFLOW))
+            {
+                result = true;
+            }
+        }
+    }
+    
+    return result;
+}
+
+// NOTE(bSalmon): Sleeps in poll until the folder changes or the listing is freed, so the render thread only checks a flag
+bsint_function void *BSInternal_FolderWatchWorker(void *param)
+{
+    BSInternal_DirListing *listing = (BSInternal_DirListing *)param;
+    
+    for (;;)
+    {
+        struct pollfd pollFDs[2] = {};
+        pollFDs[0].fd = listing->inotifyFD;
+        pollFDs[0].events = POLLIN;
+        pollFDs[1].fd = listing->watchStopFD;
+        pollFDs[1].events = POLLIN;
+        
+        if (poll(pollFDs, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        
+        if (pollFDs[1].revents)
+        {
+            break;
+        }
+        
+        if (BSInternal_ReadFolderEvents(listing))
+        {
+            BSInternal_StoreRelease(&listing->folderChanged, 1);
+            BSInternal_WakeContext(listing->context);
+        }
+    }
+    
+    return 0;
+}
+
+bsint_function void BSInternal_StopFolderWatcher(BSInternal_DirListing *listing)
+{
+    if (listing->watching)
+    {
+        bsint_u64 stop = 1;
+        if (write(listing->watchStopFD, &stop, sizeof(stop)) == sizeof(stop))
+        {
+            pthread_join(listing->watchThread, 0);
+        }
+        listing->watching = false;
+    }
+    
+    if (listing->watchStopFD >= 0)
+    {
+        close(listing->watchStopFD);
+        listing->watchStopFD = -1;
+    }
+}
+#endif
+
+bsint_function void BSInternal_WatchFolder(BSInternal_DirListing *listing)
+{
+    listing->context = bs842_internal_context;
+    
+#ifdef _WIN32
+    // NOTE(bSalmon): The watcher waits on the old handle, so it's stopped before the handle is replaced
+    BSInternal_StopFolderWatcher(listing);
+    BSInternal_UnwatchFolder(listing);
+    listing->changeHandle = FindFirstChangeNotificationA(listing->folder, FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME);
+    if (listing->changeHandle != INVALID_HANDLE_VALUE)
+    {
+        listing->watchStopEvent = CreateEventA(0, TRUE, FALSE, 0);
+        if (listing->watchStopEvent)
+        {
+            listing->watchThread = CreateThread(0, 0, BSInternal_FolderWatchWorker, listing, 0, 0);
+            listing->watching = (listing->watchThread != 0);
+        }
+    }
+#elif defined(BSINTERNAL_LINUX)
+    if (listing->inotifyFD <= 0)
+    {
+        listing->inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (listing->inotifyFD > 0)
+        {
+            listing->watchStopFD = eventfd(0, EFD_CLOEXEC);
+            listing->watching = ((listing->watchStopFD >= 0) &&
+                                 (pthread_create(&listing->watchThread, 0, BSInternal_FolderWatchWorker, listing) == 0));
+        }
+    }
+    
+    if (listing->inotifyFD > 0)
+    {
+        // NOTE(bSalmon): Re-adding the same folder hands back the existing watch, so a refresh doesn't drop and re-create it
+        int newWatch = inotify_add_watch(listing->inotifyFD, listing->folder,
+                                         IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+        if ((listing->watchDescriptor >= 0) && (listing->watchDescriptor != newWatch))
+        {
+            inotify_rm_watch(listing->inotifyFD, listing->watchDescriptor);
+        }
+        BSInternal_StoreRelease((volatile bsint_u32 *)&listing->watchDescriptor, (bsint_u32)newWatch);
+    }
+#endif
+}
+
+// NOTE(bSalmon): Non-blocking, consumes any pending notifications. This is only a flag check unless the watcher thread
+// couldn't be started, then the watch is read here and polled every BSINTERNAL_FOLDER_POLL_MICROSECONDS
+bsint_function bsint_b32 BSInternal_FolderChanged(BSInternal_DirListing *listing)
+{
+    bsint_b32 result = false;
+    
+    if (listing->watching)
+    {
+        result = BSInternal_AtomicExchange(&listing->folderChanged, 0);
+    }
+#ifdef _WIN32
+    else if (listing->changeHandle && (listing->changeHandle != INVALID_HANDLE_VALUE))
+    {
+        if (WaitForSingleObject(listing->changeHandle, 0) == WAIT_OBJECT_0)
+        {
+            result = true;
+            FindNextChangeNotification(listing->changeHandle);
+        }
+        BS842_Imgui_RequestRedraw(BSINTERNAL_FOLDER_POLL_MICROSECONDS);
+    }
+#elif defined(BSINTERNAL_LINUX)
+    else if ((listing->inotifyFD > 0) && (listing->watchDescriptor >= 0))
+    {
+        result = BSInternal_ReadFolderEvents(listing);
+        BS842_Imgui_RequestRedraw(BSINTERNAL_FOLDER_POLL_MICROSECONDS);
+    }
+#endif
+    
+    return result;
+}
+
+// NOTE(bSalmon): Case-insensitive compare where runs of digits are compared by value, so "lap9" sorts before "lap10"
+bsint_function bsint_s32 BSInternal_NaturalCompare(char *a, char *b)
+{
+    while (*a && *b)
+    {
+        if (BSInternal_IsDigit(*a) && BSInternal_IsDigit(*b))
+        {
+            while (*a == '0') { ++a; }
+            while (*b == '0') { ++b; }
+            
+            bsint_s32 digitsA = 0;
+            bsint_s32 digitsB = 0;
+            while (BSInternal_IsDigit(a[digitsA])) { ++digitsA; }
+            while (BSInternal_IsDigit(b[digitsB])) { ++digitsB; }
+            
+            if (digitsA != digitsB)
+            {
+                return digitsA - digitsB;
+            }
+            
+            for (bsint_s32 digitIndex = 0; digitIndex < digitsA; ++digitIndex)
+            {
+                if (a[digitIndex] != b[digitIndex])
+                {
+                    return a[digitIndex] - b[digitIndex];
+                }
+            }
+            
+            a += digitsA;
+            b += digitsB;
+        }
+        else
+        {
+            char lowerA = BSInternal_ToLower(*a);
+            char lowerB = BSInternal_ToLower(*b);
+            if (lowerA != lowerB)
+            {
+                return lowerA - lowerB;
+            }
+            
+            ++a;
+            ++b;
+        }
+    }
+    
+    return (bsint_s32)(bsint_u8)*a - (bsint_s32)(bsint_u8)*b;
+}
+
+inline bsint_b32 BSInternal_IsParentEntry(char *name)
+{
+    bsint_b32 result = ((name[0] == '.') && (name[1] == '.') && (name[2] == '\0'));
+    return result;
+}
+
+// NOTE(bSalmon): ".." first, then folders, then files, each in natural order
+inline bsint_b32 BSInternal_DirEntryLessEqual(BSInternal_DirEntryArray *array, BSInternal_DirEntry *a, BSInternal_DirEntry *b)
+{
+    char *nameA = array->names + a->nameOffset;
+    char *nameB = array->names + b->nameOffset;
+    
+    bsint_b32 aIsParent = BSInternal_IsParentEntry(nameA);
+    bsint_b32 bIsParent = BSInternal_IsParentEntry(nameB);
+    if (aIsParent != bIsParent)
+    {
+        return aIsParent;
+    }
+    
+    if (a->type != b->type)
+    {
+        return (a->type == FindResult_Folder);
+    }
+    
+    return (BSInternal_NaturalCompare(nameA, nameB) <= 0);
+}
+
+// NOTE(bSalmon): Bottom-up merge sort, stable and O(n log n) for large folders
+bsint_function void BSInternal_SortDirEntries(BSInternal_DirEntryArray *array)
+{
+    bsint_s32 count = array->entryCount;
+    if (count < 2)
+    {
+        return;
+    }
+    
+    BSInternal_DirEntry *src = array->entries;
+    BSInternal_DirEntry *dest = (BSInternal_DirEntry *)BSINTERNAL_MALLOC(count * sizeof(BSInternal_DirEntry));
+    BSInternal_DirEntry *scratch = dest;
+    
+    for (bsint_s32 width = 1; width < count; width *= 2)
+    {
+        for (bsint_s32 start = 0; start < count; start += 2 * width)
+        {
+            bsint_s32 mid = ((start + width) < count) ? (start + width) : count;
+            bsint_s32 end = ((start + 2 * width) < count) ? (start + 2 * width) : count;
+            
+            bsint_s32 left = start;
+            bsint_s32 right = mid;
+            for (bsint_s32 out = start; out < end; ++out)
+            {
+                if ((left < mid) && ((right >= end) || BSInternal_DirEntryLessEqual(array, &src[left], &src[right])))
+                {
+                    dest[out] = src[left++];
+                }
+                else
+                {
+                    dest[out] = src[right++];
+                }
+            }
+        }
+        
+        INTERNAL_SWAP(src, dest);
+    }
+    
+    if (src != array->entries)
+    {
+        bs842_internal_CopyMem(array->entries, src, count * sizeof(BSInternal_DirEntry));
+    }
+    
+    free(scratch);
+}
+
+inline bsint_u32 BSInternal_TrigramBucket(char *trigram)
+{
+    bsint_u32 hash = (((bsint_u32)(bsint_u8)trigram[0] * 0x9E3779B1u) ^
+                      ((bsint_u32)(bsint_u8)trigram[1] * 0x85EBCA77u) ^
+                      ((bsint_u32)(bsint_u8)trigram[2] * 0xC2B2AE3Du));
+    return (hash >> (32 - BSINTERNAL_TRIGRAM_BUCKET_BITS));
+}
+
+// NOTE(bSalmon): Letters get a bit each, the rest share the remaining six. c must already be lowercase
+inline bsint_u32 BSInternal_CharClassBit(char c)
+{
+    bsint_u32 bit = 31;
+    if ((c >= 'a') && (c <= 'z'))
+    {
+        bit = c - 'a';
+    }
+    else if (BSInternal_IsDigit(c))
+    {
+        bit = 26 + ((c - '0') / 4);
+    }
+    else if (c == '.')
+    {
+        bit = 29;
+    }
+    else if ((c == '_') || (c == '-') || (c == ' '))
+    {
+        bit = 30;
+    }
+    
+    return (1u << bit);
+}
+
+bsint_function void BSInternal_BuildFilterIndex(BSInternal_FilterIndex *index, BSInternal_DirEntryArray *array)
+{
+    if (array->namesUsed > index->lowerNamesCapacity)
+    {
+        index->lowerNamesCapacity = array->namesUsed;
+        index->lowerNames = (char *)BSINTERNAL_REALLOC(index->lowerNames, index->lowerNamesCapacity);
+    }
+    
+    for (bsint_s32 charIndex = 0; charIndex < array->namesUsed; ++charIndex)
+    {
+        index->lowerNames[charIndex] = BSInternal_ToLower(array->names[charIndex]);
+    }
+    
+    if (array->entryCount > index->charMasksCapacity)
+    {
+        index->charMasksCapacity = array->entryCount;
+        index->charMasks = (bsint_u32 *)BSINTERNAL_REALLOC(index->charMasks, index->charMasksCapacity * sizeof(bsint_u32));
+    }
+    
+    for (bsint_s32 entryIndex = 0; entryIndex < array->entryCount; ++entryIndex)
+    {
+        bsint_u32 mask = 0;
+        for (char *scan = index->lowerNames + array->entries[entryIndex].nameOffset; *scan; ++scan)
+        {
+            mask |= BSInternal_CharClassBit(*scan);
+        }
+        index->charMasks[entryIndex] = mask;
+    }
+    
+    if (!index->bucketStart)
+    {
+        index->bucketStart = (bsint_s32 *)BSINTERNAL_MALLOC((BSINTERNAL_TRIGRAM_BUCKETS + 1) * sizeof(bsint_s32));
+    }
+    bsint_s32 *lastEntry = (bsint_s32 *)BSINTERNAL_MALLOC(BSINTERNAL_TRIGRAM_BUCKETS * sizeof(bsint_s32));
+    
+    // NOTE(bSalmon): Count pass then fill pass, each entry is only posted once per bucket
+    for (bsint_s32 bucket = 0; bucket <= BSINTERNAL_TRIGRAM_BUCKETS; ++bucket)
+    {
+        index->bucketStart[bucket] = 0;
+    }
+    for (bsint_s32 bucket = 0; bucket < BSINTERNAL_TRIGRAM_BUCKETS; ++bucket)
+    {
+        lastEntry[bucket] = -1;
+    }
+    
+    for (bsint_s32 entryIndex = 0; entryIndex < array->entryCount; ++entryIndex)
+    {
+        char *name = index->lowerNames + array->entries[entryIndex].nameOffset;
+        for (bsint_s32 charIndex = 0; name[charIndex] && name[charIndex + 1] && name[charIndex + 2]; ++charIndex)
+        {
+            bsint_u32 bucket = BSInternal_TrigramBucket(&name[charIndex]);
+            if (lastEntry[bucket] != entryIndex)
+            {
+                lastEntry[bucket] = entryIndex;
+                ++index->bucketStart[bucket + 1];
+            }
+        }
+    }
+    
+    for (bsint_s32 bucket = 0; bucket < BSINTERNAL_TRIGRAM_BUCKETS; ++bucket)
+    {
+        index->bucketStart[bucket + 1] += index->bucketStart[bucket];
+        lastEntry[bucket] = -1;
+    }
+    
+    bsint_s32 postingCount = index->bucketStart[BSINTERNAL_TRIGRAM_BUCKETS];
+    if (postingCount > index->postingsCapacity)
+    {
+        index->postingsCapacity = postingCount;
+        index->postings = (bsint_s32 *)BSINTERNAL_REALLOC(index->postings, index->postingsCapacity * sizeof(bsint_s32));
+    }
+    
+    bsint_s32 *cursor = (bsint_s32 *)BSINTERNAL_MALLOC(BSINTERNAL_TRIGRAM_BUCKETS * sizeof(bsint_s32));
+    bs842_internal_CopyMem(cursor, index->bucketStart, BSINTERNAL_TRIGRAM_BUCKETS * sizeof(bsint_s32));
+    for (bsint_s32 entryIndex = 0; entryIndex < array->entryCount; ++entryIndex)
+    {
+        char *name = index->lowerNames + array->entries[entryIndex].nameOffset;
+        for (bsint_s32 charIndex = 0; name[charIndex] && name[charIndex + 1] && name[charIndex + 2]; ++charIndex)
+        {
+            bsint_u32 bucket = BSInternal_TrigramBucket(&name[charIndex]);
+            if (lastEntry[bucket] != entryIndex)
+            {
+                lastEntry[bucket] = entryIndex;
+                index->postings[cursor[bucket]++] = entryIndex;
+            }
+        }
+    }
+    
+    free(cursor);
+    free(lastEntry);
+    index->built = true;
+}
+
+inline void BSInternal_FreeFilterIndex(BSInternal_FilterIndex *index)
+{
+    free(index->lowerNames);
+    free(index->charMasks);
+    free(index->bucketStart);
+    free(index->postings);
+    *index = {};
+}
+
+// NOTE(bSalmon): needle must already be lowercase
+inline bsint_b32 BSInternal_ContainsLower(char *haystack, bsint_b32 haystackIsLower, char *needle, bsint_s32 needleLength)
+{
+    for (char *start = haystack; *start; ++start)
+    {
+        bsint_s32 matched = 0;
+        while ((matched < needleLength) && start[matched] &&
+               ((haystackIsLower ? start[matched] : BSInternal_ToLower(start[matched])) == needle[matched]))
+        {
+            ++matched;
+        }
+        
+        if (matched == needleLength)
+        {
+            return true;
+        }
+    }
+    
+    return (needleLength == 0);
+}
+
+// NOTE(bSalmon): A keystroke that extends the query only re-checks the previous matches. Otherwise the candidates are the
+// smallest trigram bucket of the query, or every entry when there's no index yet (still loading) or the query is shorter
+// than a trigram. ".." is never filtered out
+bsint_function void BSInternal_UpdateFilter(BSInternal_FilterState *filter, BSInternal_DirEntryArray *array, BSInternal_FilterIndex *index, bsint_u32 generation)
 {
-    if (bs842_internal_info.clicked)
+    if (filter->queryLength == 0)
+    {
+        filter->matchesValid = false;
+        return;
+    }
+    
+    char lowerQuery[BSINTERNAL_MAX_FILTER_LENGTH] = {};
+    bsint_u32 queryMask = 0;
+    for (bsint_s32 charIndex = 0; charIndex < filter->queryLength; ++charIndex)
+    {
+        lowerQuery[charIndex] = BSInternal_ToLower(filter->query[charIndex]);
+        queryMask |= BSInternal_CharClassBit(lowerQuery[charIndex]);
+    }
+    
+    bsint_b32 sameListing = (filter->matchesValid && (filter->matchedGeneration == generation));
+    if (sameListing && bs842_internal_StringCompare(lowerQuery, filter->matchedQuery))
+    {
+        return;
+    }
+    
+    if (filter->matchCapacity < array->entryCount)
     {
-        bs842_internal_info.clicked = false;
+        filter->matchCapacity = array->entryCount;
+        filter->matches = (bsint_s32 *)BSINTERNAL_REALLOC(filter->matches, filter->matchCapacity * sizeof(bsint_s32));
     }
     
-    if (bs842_internal_info.dblClicked)
+    bsint_s32 *candidates = 0;
+    bsint_s32 candidateCount = array->entryCount;
+    if (sameListing && BSInternal_ContainsLower(lowerQuery, true, filter->matchedQuery, filter->matchedQueryLength))
     {
-        bs842_internal_info.dblClicked = false;
+        candidates = filter->matches;
+        candidateCount = filter->matchCount;
     }
     
-    if (bs842_internal_info.scrolledUp)
+    if (index->built && (filter->queryLength >= 3))
     {
-        bs842_internal_info.scrolledUp = false;
+        for (bsint_s32 charIndex = 0; charIndex + 2 < filter->queryLength; ++charIndex)
+        {
+            bsint_u32 bucket = BSInternal_TrigramBucket(&lowerQuery[charIndex]);
+            bsint_s32 bucketCount = index->bucketStart[bucket + 1] - index->bucketStart[bucket];
+            if (bucketCount < candidateCount)
+            {
+                candidates = index->postings + index->bucketStart[bucket];
+                candidateCount = bucketCount;
+            }
+        }
     }
     
-    if (bs842_internal_info.scrolledDown)
+    bsint_s32 matchCount = 0;
+    bsint_b32 hasParent = ((array->entryCount > 0) && BSInternal_IsParentEntry(array->names + array->entries[0].nameOffset));
+    if (hasParent)
     {
-        bs842_internal_info.scrolledDown = false;
+        filter->matches[matchCount++] = 0;
     }
     
-    if (bs842_internal_info.currentID != 1)
+    // NOTE(bSalmon): Candidates are ascending entry indices and never behind the write position, so matches can be
+    // compacted in place and stay in listing order
+    for (bsint_s32 candidateIndex = 0; candidateIndex < candidateCount; ++candidateIndex)
     {
-        bs842_internal_info.currentID = 1;
+        bsint_s32 entryIndex = candidates ? candidates[candidateIndex] : candidateIndex;
+        if (hasParent && (entryIndex == 0))
+        {
+            continue;
+        }
+        
+        BSInternal_DirEntry *entry = &array->entries[entryIndex];
+        bsint_b32 isMatch = false;
+        if (index->built)
+        {
+            isMatch = (((index->charMasks[entryIndex] & queryMask) == queryMask) &&
+                       BSInternal_ContainsLower(index->lowerNames + entry->nameOffset, true, lowerQuery, filter->queryLength));
+        }
+        else
+        {
+            isMatch = BSInternal_ContainsLower(array->names + entry->nameOffset, false, lowerQuery, filter->queryLength);
+        }
+        if (isMatch)
+        {
+            filter->matches[matchCount++] = entryIndex;
+        }
     }
+    
+    filter->matchCount = matchCount;
+    bs842_internal_CopyMem(filter->matchedQuery, lowerQuery, BSINTERNAL_MAX_FILTER_LENGTH);
+    filter->matchedQueryLength = filter->queryLength;
+    filter->matchedGeneration = generation;
+    filter->matchesValid = true;
 }
 
-bsint_function BS842_Prim_SizeSpec BS842_MenuBar()
+inline bsint_b32 BSInternal_IsSkippedDirEntry(char *name, bsint_b32 isRoot)
 {
-    BS842_Prim_SizeSpec result = BS842_FillSizeSpec(0.0f, 1.0f, 0.0f, 0.04f);
-    
-    BS842_Prim_SizeSpec boxSizeSpec = result;
-    BS842_Prim_SizeSpec lineSizeSpec = BS842_FillSizeSpec(result.x1, result.x2, result.y2, result.y2);
-    BS842_DrawSolidBox(bs842_internal_info.backBuffer, boxSizeSpec, bs842_internal_info.theme.menuBarBackground);
-    BS842_DrawLine(bs842_internal_info.backBuffer, lineSizeSpec, 3.0f, bs842_internal_info.theme.elemOutline);
-    
-    return result;
+    return ((name[0] == '.') && ((name[1] == '\0') || (isRoot && (name[1] == '.') && (name[2] == '\0'))));
 }
 
-bsint_function bsint_b32 BS842_MenuBarItem(BS842_Prim_SizeSpec menuBarSizeSpec, bsint_s32 menuItemOrder, char *title, bsint_b32 *hasBeenClicked, BS842_Prim_SizeSpec *childAnchor = 0)
+#if defined(BSINTERNAL_LINUX)
+// NOTE(bSalmon): Layout the kernel uses for getdents64 records
+struct BSInternal_LinuxDirent64
 {
-    bsint_b32 result = false;
-    
-    bsint_f32 itemWidth = 0.1f;
-    bsint_f32 itemLeft = ((bsint_f32)menuItemOrder * itemWidth) + 0.0075f;
-    BS842_Prim_SizeSpec sizeSpec = BS842_FillSizeSpec(itemLeft, itemLeft + itemWidth, menuBarSizeSpec.y1, menuBarSizeSpec.y2 - 0.004f);
-    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(bs842_internal_info.backBuffer, sizeSpec);
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+bsint_function void BSInternal_FreeDirEnumJob(BSInternal_DirEnumJob *job)
+{
+    pthread_mutex_destroy(&job->mutex);
+    BSInternal_FreeDirEntries(&job->pending);
+    BSInternal_FreeDirEntries(&job->complete);
+    BSInternal_FreeFilterIndex(&job->completeIndex);
+    free(job);
+}
+
+// NOTE(bSalmon): Reads the folder with getdents64 and hands entries to the UI thread one kernel buffer at a time. d_type
+// is used directly, entries are only stat'd when the filesystem doesn't report a type. The worker also builds and sorts
+// the full listing itself so the UI thread never has to sort a large folder
+bsint_function void *BSInternal_DirEnumWorker(void *param)
+{
+    BSInternal_DirEnumJob *job = (BSInternal_DirEnumJob *)param;
     
-    bsint_b32 hovered = (((bs842_internal_info.mouseX >= int_sizeSpec.x1) && (bs842_internal_info.mouseX <= int_sizeSpec.x2)) &&
-                         ((bs842_internal_info.mouseY >= int_sizeSpec.y1) && (bs842_internal_info.mouseY <= int_sizeSpec.y2))) ? true : false;
+    BSInternal_DirEntryArray batch = {};
+    bsint_b32 isRoot = ((job->folder[0] == BSINTERNAL_PATH_SEPARATOR) && (job->folder[1] == '\0'));
     
-    if (hovered)
+    int dirFD = open(job->folder, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFD >= 0)
     {
-        BS842_DrawSolidBox(bs842_internal_info.backBuffer, sizeSpec, bs842_internal_info.theme.menuItemHovered);
-        if (bs842_internal_info.clicked)
+        char *direntBuffer = (char *)BSINTERNAL_MALLOC(64 * 1024);
+        bsint_b32 cancelled = false;
+        while (!cancelled)
         {
-            *hasBeenClicked = true;
+            long bytesRead = syscall(SYS_getdents64, dirFD, direntBuffer, 64 * 1024);
+            if (bytesRead <= 0)
+            {
+                break;
+            }
+            
+            for (long offset = 0; offset < bytesRead;)
+            {
+                BSInternal_LinuxDirent64 *dirent = (BSInternal_LinuxDirent64 *)(direntBuffer + offset);
+                offset += dirent->d_reclen;
+                
+                char *name = dirent->d_name;
+                if (BSInternal_IsSkippedDirEntry(name, isRoot))
+                {
+                    continue;
+                }
+                
+                bsint_b32 isFolder = (dirent->d_type == DT_DIR);
+                if ((dirent->d_type == DT_UNKNOWN) || (dirent->d_type == DT_LNK))
+                {
+                    struct stat fileStat;
+                    isFolder = ((fstatat(dirFD, name, &fileStat, 0) == 0) && S_ISDIR(fileStat.st_mode));
+                }
+                
+                bsint_s32 nameLength = bs842_internal_StringLength(name);
+                if (isFolder)
+                {
+                    BSInternal_AddDirEntry(&batch, name, nameLength, FindResult_Folder);
+                }
+                else if (BSInternal_MatchesExtension(&job->matcher, name, nameLength))
+                {
+                    BSInternal_AddDirEntry(&batch, name, nameLength, FindResult_File);
+                }
+            }
+            
+            BSInternal_AppendDirEntries(&job->complete, &batch);
+            
+            pthread_mutex_lock(&job->mutex);
+            BSInternal_AppendDirEntries(&job->pending, &batch);
+            cancelled = job->cancel;
+            if (!cancelled)
+            {
+                BSInternal_WakeContext(job->context);
+            }
+            pthread_mutex_unlock(&job->mutex);
+            
+            BSInternal_ClearDirEntries(&batch);
+        }
+        
+        free(direntBuffer);
+        close(dirFD);
+        
+        if (!cancelled)
+        {
+            BSInternal_SortDirEntries(&job->complete);
+            BSInternal_BuildFilterIndex(&job->completeIndex, &job->complete);
         }
     }
-    else
+    
+    // NOTE(bSalmon): The context is only woken with the mutex held and cancel clear, so it's never touched after the
+    // listing gives up on the job (and may be freeing the context)
+    pthread_mutex_lock(&job->mutex);
+    job->done = true;
+    bsint_b32 abandoned = job->cancel;
+    if (!abandoned)
     {
-        BS842_DrawSolidBox(bs842_internal_info.backBuffer, sizeSpec, bs842_internal_info.theme.menuBarBackground);
-        *hasBeenClicked = false;
+        BSInternal_WakeContext(job->context);
     }
+    pthread_mutex_unlock(&job->mutex);
     
-    BS842_DrawLine(bs842_internal_info.backBuffer, BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x1, sizeSpec.y1, sizeSpec.y2), 1.0f, bs842_internal_info.theme.menuItemBorder);
-    BS842_DrawLine(bs842_internal_info.backBuffer, BS842_FillSizeSpec(sizeSpec.x2, sizeSpec.x2, sizeSpec.y1, sizeSpec.y2), 1.0f, bs842_internal_info.theme.menuItemBorder);
-    
-    bsint_s32 textSizeY = (bsint_s32)(((sizeSpec.y2 - sizeSpec.y1) * bs842_internal_info.backBuffer->height) * 0.9f);
-    unsigned char *textBitmap = (unsigned char *)malloc(bs842_internal_info.backBuffer->pitch * textSizeY);
-    bs842_internal_ZeroMem(textBitmap, bs842_internal_info.backBuffer->pitch * textSizeY);
-    bsint_f32 charX = 0.0f;
-    BS842_CreateTextBitmap(textBitmap, &bs842_internal_info.fontInfo, title, (bsint_f32)textSizeY, bs842_internal_info.backBuffer->width, &charX);
-    BS842_DrawTextBitmap(bs842_internal_info.backBuffer, textBitmap, bs842_internal_info.theme.defaultText, charX, sizeSpec.x1 + 0.0025f, sizeSpec.y1 + 0.0025f, bs842_internal_info.backBuffer->width, textSizeY, true);
-    
-    free(textBitmap);
-    
-    if (childAnchor)
+    BSInternal_FreeDirEntries(&batch);
+    if (abandoned)
     {
-        *childAnchor = BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x1, sizeSpec.y2, sizeSpec.y2);
+        BSInternal_FreeDirEnumJob(job);
     }
-    
-    if (*hasBeenClicked)
+    return 0;
+}
+
+// NOTE(bSalmon): Never waits on the worker. One that's still reading is detached and frees the job when it sees the
+// cancel, so leaving a slow folder doesn't stall the UI thread
+bsint_function void BSInternal_StopDirEnumJob(BSInternal_DirListing *listing)
+{
+    BSInternal_DirEnumJob *job = listing->job;
+    if (job)
     {
-        result = true;
-        }
+        pthread_mutex_lock(&job->mutex);
+        job->cancel = true;
+        bsint_b32 done = job->done;
+        pthread_t thread = job->thread;
+        pthread_mutex_unlock(&job->mutex);
         
-    return result;
+        if (done)
+        {
+            pthread_join(thread, 0);
+            BSInternal_FreeDirEnumJob(job);
+        }
+        else
+        {
+            pthread_detach(thread);
+        }
+        listing->job = 0;
+    }
 }
+#endif
 
-bsint_function void BS842_TextBox(BS842_Prim_SizeSpec *anchor, char *text, bsint_f32 fontLineHeight = 5.0f, bsint_f32 xPos = 0.0f, bsint_f32 yPos = 0.0f)
+// NOTE(bSalmon): Linux enumerates on a worker thread and the listing fills in over the following frames. A refresh of
+// the folder already shown keeps the old entries until the new listing is complete, so the list doesn't empty out
+// every time a file is written into it
+bsint_function void BSInternal_BeginEnumeration(BSInternal_DirListing *listing, char *folder, char *fileTypes)
 {
-    bsint_s32 lineCount = 0;
-    bsint_s32 ch = 0;
+    bsint_b32 sameFolder = bs842_internal_StringCompare(listing->folder, folder) && bs842_internal_StringCompare(listing->fileTypes, fileTypes);
     
-    char *stringStartPos = text;
-    bsint_s32 currStringCharCount = 0;
-    bsint_s32 longestStringCharCount = 1;
-    BSInternal_StringNode stringSentinel = {};
-    stringSentinel.prev = &stringSentinel;
-    stringSentinel.next = &stringSentinel;
+    bsint_s32 folderLength = bs842_internal_StringLength(folder);
+    bs842_internal_CopyMem(listing->folder, folder, folderLength);
+    listing->folder[folderLength] = '\0';
     
-    bsint_s32 strLen = bs842_internal_StringLength(text);
-    char *textTemp = (char *)malloc(strLen + 2);
-    bs842_internal_CopyMem(textTemp, text, strLen);
-    bs842_internal_ConcatenateStrings(strLen, textTemp, 1, "\n\0", textTemp);
+    bsint_s32 typesLength = bs842_internal_StringLength(fileTypes);
+    typesLength = (typesLength < BSINTERNAL_MAX_FILE_TYPES_LENGTH) ? typesLength : BSINTERNAL_MAX_FILE_TYPES_LENGTH - 1;
+    bs842_internal_CopyMem(listing->fileTypes, fileTypes, typesLength);
+    listing->fileTypes[typesLength] = '\0';
+    BSInternal_CompileExtensionMatcher(&listing->matcher, listing->fileTypes);
+    
+    // NOTE(bSalmon): Watch before enumerating so nothing created in between is missed
+    BSInternal_WatchFolder(listing);
+    
+    listing->valid = true;
+    ++listing->generation;
+    
+#ifdef _WIN32
+    BSInternal_ClearDirEntries(&listing->array);
     
-    while (textTemp[ch])
+    HANDLE findHandle = INVALID_HANDLE_VALUE;
+    WIN32_FIND_DATA findData = {};
+    char findDir[MAX_PATH] = {};
+    bs842_internal_ConcatenateStrings(folderLength, folder, 2, (char *)"*\0", findDir);
+    findHandle = FindFirstFile(findDir, &findData);
+    INTERNAL_ASSERT(findHandle != INVALID_HANDLE_VALUE);
+    
+    do
     {
-        ++currStringCharCount;
-        
-        if (textTemp[ch] == '\n')
+        bsint_s32 nameLength = bs842_internal_StringLength(findData.cFileName);
+        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
         {
-            lineCount++;
-            
-            BSInternal_StringNode *stringNode = AddStringNode(&stringSentinel, currStringCharCount);
-            bs842_internal_CopyMem(stringNode->string, stringStartPos, currStringCharCount - 1);
-            stringNode->string[currStringCharCount - 1] = '\0';
-            
-            if (currStringCharCount > longestStringCharCount)
+            if (!BSInternal_IsSkippedDirEntry(findData.cFileName, false))
             {
-                longestStringCharCount = currStringCharCount;
+                BSInternal_AddDirEntry(&listing->array, findData.cFileName, nameLength, FindResult_Folder);
             }
-            
-            stringStartPos = &textTemp[ch + 1];
-            currStringCharCount = 0;
         }
-        
-        ++ch;
+        else if (BSInternal_MatchesExtension(&listing->matcher, findData.cFileName, nameLength))
+        {
+            BSInternal_AddDirEntry(&listing->array, findData.cFileName, nameLength, FindResult_File);
+        }
     }
+    while (FindNextFile(findHandle, &findData) != 0);
+    FindClose(findHandle);
     
-    free(textTemp);
+    BSInternal_SortDirEntries(&listing->array);
+    BSInternal_BuildFilterIndex(&listing->index, &listing->array);
+#elif defined(BSINTERNAL_LINUX)
+    BSInternal_StopDirEnumJob(listing);
     
-    if (anchor)
+    listing->progressive = !sameFolder;
+    if (listing->progressive)
     {
-        xPos = anchor->x1;
-        yPos = anchor->y2;
+        BSInternal_ClearDirEntries(&listing->array);
+        listing->index.built = false;
     }
-        
-        bsint_f32 yCursor = yPos + 0.005f;
-    bsint_s32 textSizeY = fontLineHeight; // TODO(bSalmon): Convert to scale with window size
-        
-        bsint_s32 xPosS = bs842_prim_internal_RoundF32ToS32(xPos * bs842_internal_info.backBuffer->width);
-        xPosS = (xPosS < 0) ? 0 : ((xPosS > bs842_internal_info.backBuffer->width) ? bs842_internal_info.backBuffer->width : xPosS);
-        bsint_s32 yPosS = bs842_prim_internal_RoundF32ToS32(yPos * bs842_internal_info.backBuffer->height);
-        yPosS = (yPosS < 0) ? 0 : ((yPosS > bs842_internal_info.backBuffer->width) ? bs842_internal_info.backBuffer->height : yPosS);
-        
-        bsint_s32 boxBottom = yPosS + ((textSizeY + (bsint_s32)(0.005f * bs842_internal_info.backBuffer->height)) * lineCount) + (bsint_s32)(0.01f * bs842_internal_info.backBuffer->height);
-        bsint_s32 boxRight = xPosS + ((bsint_s32)(textSizeY * 0.5f) * longestStringCharCount);
-        
-        BSInternal_SizeSpec sizeSpec = BS842_FillSizeSpec(xPosS, boxRight, yPosS, boxBottom);
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 1.0f, bs842_internal_info.theme.elemBackground, bs842_internal_info.theme.elemOutline);
-        
-        for (BSInternal_StringNode *stringNode = stringSentinel.prev; stringNode != &stringSentinel; stringNode = stringNode->prev)
+    
+    BSInternal_DirEnumJob *job = (BSInternal_DirEnumJob *)BSINTERNAL_CALLOC(1, sizeof(BSInternal_DirEnumJob));
+    bs842_internal_CopyMem(job->folder, listing->folder, MAX_PATH);
+    job->matcher = listing->matcher;
+    job->context = bs842_internal_context;
+    pthread_mutex_init(&job->mutex, 0);
+    if (pthread_create(&job->thread, 0, BSInternal_DirEnumWorker, job) == 0)
+    {
+        listing->job = job;
+    }
+    else
+    {
+        BSInternal_FreeDirEnumJob(job);
+    }
+    listing->loading = (listing->job != 0);
+#else
+    BSInternal_ClearDirEntries(&listing->array);
+    
+    DIR *dir = opendir(folder);
+    if (dir)
+    {
+        bsint_b32 isRoot = ((folder[0] == BSINTERNAL_PATH_SEPARATOR) && (folder[1] == '\0'));
+        for (struct dirent *dirEntry = readdir(dir); dirEntry; dirEntry = readdir(dir))
         {
-            if (stringNode->string[0] != '\0')
+            char *name = dirEntry->d_name;
+            if (BSInternal_IsSkippedDirEntry(name, isRoot))
             {
-                unsigned char *textBitmap = (unsigned char *)malloc(bs842_internal_info.backBuffer->pitch * textSizeY);
-                bs842_internal_ZeroMem(textBitmap, bs842_internal_info.backBuffer->pitch * textSizeY);
-        bsint_f32 charX = 0.0f;
-        BS842_CreateTextBitmap(textBitmap, &bs842_internal_info.fontInfo, stringNode->string, fontLineHeight, bs842_internal_info.backBuffer->width, &charX);
-        BS842_DrawTextBitmap(bs842_internal_info.backBuffer, textBitmap, bs842_internal_info.theme.defaultText, charX, xPos + 0.005f, yCursor, bs842_internal_info.backBuffer->width, textSizeY, true);
-        
-            free(textBitmap);
+                continue;
+            }
+            
+            bsint_b32 isFolder = (dirEntry->d_type == DT_DIR);
+            if ((dirEntry->d_type == DT_UNKNOWN) || (dirEntry->d_type == DT_LNK))
+            {
+                char fullPath[MAX_PATH] = {};
+                bs842_internal_ConcatenateStrings(folderLength, folder, bs842_internal_StringLength(name), name, fullPath);
+                struct stat fileStat;
+                isFolder = ((stat(fullPath, &fileStat) == 0) && S_ISDIR(fileStat.st_mode));
             }
             
-            yCursor += (fontLineHeight / bs842_internal_info.backBuffer->height) + 0.005f;
+            bsint_s32 nameLength = bs842_internal_StringLength(name);
+            if (isFolder)
+            {
+                BSInternal_AddDirEntry(&listing->array, name, nameLength, FindResult_Folder);
+            }
+            else if (BSInternal_MatchesExtension(&listing->matcher, name, nameLength))
+            {
+                BSInternal_AddDirEntry(&listing->array, name, nameLength, FindResult_File);
+            }
         }
         
-        for (BSInternal_StringNode *stringNode = stringSentinel.next; stringNode != &stringSentinel; stringNode = stringSentinel.next)
-        {
-            RemoveStringNode(stringNode);
-        }
-}
-
-bsint_function void BSInternal_DrawBasicWindow(void *buffer, char *title, BS842_Prim_SizeSpec sizeSpec)
-{
-    bsint_f32 titleBarRatio = 0.05f;
-    BS842_DrawSolidBox(buffer, BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x2, sizeSpec.y1, sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * titleBarRatio)), bs842_internal_info.theme.menuBarBackground);
-    BS842_DrawSolidBox(buffer, BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x2, sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * titleBarRatio), sizeSpec.y2), bs842_internal_info.theme.elemBackground);
-    BS842_DrawHollowBox(buffer, sizeSpec, 2.0f, bs842_internal_info.theme.elemOutline);
-    
-    BS842_Prim_SizeSpec textSizeSpec = BS842_FillSizeSpec(sizeSpec.x1, sizeSpec.x2, sizeSpec.y1, sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * titleBarRatio));
-    bsint_s32 textSizeY = (bsint_s32)(((textSizeSpec.y2 - textSizeSpec.y1) * bs842_internal_info.backBuffer->height) * 0.9f);
-    unsigned char *textBitmap = (unsigned char *)malloc(bs842_internal_info.backBuffer->pitch * textSizeY);
-    bs842_internal_ZeroMem(textBitmap, bs842_internal_info.backBuffer->pitch * textSizeY);
-    bsint_f32 charX = 0.0f;
-    BS842_CreateTextBitmap(textBitmap, &bs842_internal_info.fontInfo, title, (bsint_f32)textSizeY, bs842_internal_info.backBuffer->width, &charX);
-    BS842_DrawTextBitmap(bs842_internal_info.backBuffer, textBitmap, bs842_internal_info.theme.defaultText, charX, sizeSpec.x1 + 0.0025f, sizeSpec.y1 + 0.0025f, bs842_internal_info.backBuffer->width, textSizeY, true);
+        closedir(dir);
+    }
     
-    free(textBitmap);
+    BSInternal_SortDirEntries(&listing->array);
+    BSInternal_BuildFilterIndex(&listing->index, &listing->array);
+#endif
 }
 
-bsint_function bsint_b32 BS842_Button(BS842_Prim_SizeSpec anchor, char *label)
+// NOTE(bSalmon): Pulls in whatever the worker has produced since last frame, returns true when the listing completes
+bsint_function bsint_b32 BSInternal_PollEnumeration(BSInternal_DirListing *listing)
 {
     bsint_b32 result = false;
     
-    BS842_Prim_SizeSpec sizeSpec = anchor;
-    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(bs842_internal_info.backBuffer, sizeSpec);
-    
-    bsint_b32 hovered = (((bs842_internal_info.mouseX >= int_sizeSpec.x1) && (bs842_internal_info.mouseX <= int_sizeSpec.x2)) &&
-                         ((bs842_internal_info.mouseY >= int_sizeSpec.y1) && (bs842_internal_info.mouseY <= int_sizeSpec.y2))) ? true : false;
-    
-    if (hovered)
+#if defined(BSINTERNAL_LINUX)
+    BSInternal_DirEnumJob *job = listing->job;
+    if (job)
     {
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 2.0f, bs842_internal_info.theme.menuItemHovered, bs842_internal_info.theme.menuItemHovered);
-        if (bs842_internal_info.clicked)
+        pthread_mutex_lock(&job->mutex);
+        bsint_b32 done = job->done;
+        if (listing->progressive && !done && job->pending.entryCount)
         {
-             result = true;
+            BSInternal_AppendDirEntries(&listing->array, &job->pending);
+            ++listing->generation;
+        }
+        BSInternal_ClearDirEntries(&job->pending);
+        pthread_mutex_unlock(&job->mutex);
+        
+        if (done)
+        {
+            pthread_join(job->thread, 0);
+            INTERNAL_SWAP(listing->array, job->complete);
+            INTERNAL_SWAP(listing->index, job->completeIndex);
+            BSInternal_FreeDirEnumJob(job);
+            listing->job = 0;
+            ++listing->generation;
+            listing->loading = false;
+            result = true;
         }
     }
-    else
-    {
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 2.0f, bs842_internal_info.theme.menuBarBackground, bs842_internal_info.theme.menuItemHovered);
-    }
-    
-    bsint_s32 textSizeY = (bsint_s32)(((sizeSpec.y2 - sizeSpec.y1) * bs842_internal_info.backBuffer->height) * 0.9f);
-    unsigned char *textBitmap = (unsigned char *)malloc(bs842_internal_info.backBuffer->pitch * textSizeY);
-    bs842_internal_ZeroMem(textBitmap, bs842_internal_info.backBuffer->pitch * textSizeY);
-    bsint_f32 charX = 0.0f;
-    BS842_CreateTextBitmap(textBitmap, &bs842_internal_info.fontInfo, label, (bsint_f32)textSizeY, bs842_internal_info.backBuffer->width, &charX);
-    BS842_DrawTextBitmap(bs842_internal_info.backBuffer, textBitmap, bs842_internal_info.theme.defaultText, charX, sizeSpec.x1 + 0.0025f, sizeSpec.y1 + 0.0025f, bs842_internal_info.backBuffer->width, textSizeY, true);
-    
-    free(textBitmap);
+#endif
     
     return result;
 }
 
-struct BS842_Imgui_FileInfo
+bsint_function void BSInternal_FreeDirListing(void *data)
 {
-    char filename[MAX_PATH];
-    char currFolder[MAX_PATH];
-    bsint_s32 currFolderLength;
-    bsint_b32 hasBeenRead;
-};
+    BSInternal_DirListing *listing = (BSInternal_DirListing *)data;
+    
+#if defined(_WIN32) || defined(BSINTERNAL_LINUX)
+    BSInternal_StopFolderWatcher(listing);
+#endif
+    BSInternal_UnwatchFolder(listing);
+#if defined(BSINTERNAL_LINUX)
+    BSInternal_StopDirEnumJob(listing);
+    
+    if (listing->inotifyFD > 0)
+    {
+        close(listing->inotifyFD);
+    }
+#endif
+    
+    BSInternal_FreeDirEntries(&listing->array);
+    BSInternal_FreeFilterIndex(&listing->index);
+    free(listing->filter.matches);
+    free(listing);
+}
 
-enum BSInternal_FindResultType
+inline void BSInternal_CopyDirEntryName(char *dest, BSInternal_DirEntryArray *array, bsint_s32 entryIndex)
 {
-    FindResult_Folder,
-    FindResult_File,
-};
+    if ((entryIndex >= 0) && (entryIndex < array->entryCount))
+    {
+        char *name = array->names + array->entries[entryIndex].nameOffset;
+        bs842_internal_CopyMem(dest, name, bs842_internal_StringLength(name));
+    }
+}
 
-struct BSInternal_FindResult
+// NOTE(bSalmon): -1 if there's no entry with that name
+bsint_function bsint_s32 BSInternal_FindDirEntry(BSInternal_DirEntryArray *array, char *name)
 {
-    char *file;
-    BSInternal_FindResultType type;
-    bsint_s32 orderInList;
-    bsint_b32 selected;
+    for (bsint_s32 entryIndex = 0; name[0] && (entryIndex < array->entryCount); ++entryIndex)
+    {
+        if (bs842_internal_StringCompare(array->names + array->entries[entryIndex].nameOffset, name))
+        {
+            return entryIndex;
+        }
+    }
     
-    BSInternal_FindResult *next;
-    BSInternal_FindResult *prev;
-};
+    return -1;
+}
 
-bsint_function BSInternal_FindResult *AddFindResult(BSInternal_FindResult *sentinel, BSInternal_FindResultType type)
+bsint_function BSInternal_DirListing *BSInternal_GetDirListing(BSInternal_WidgetState *state, char *folder, char *fileTypes)
 {
-    BSInternal_FindResult *node = (BSInternal_FindResult *)malloc(sizeof(BSInternal_FindResult));
-    
-    node->file = (char *)malloc(MAX_PATH);
-    node->type = type;
-    node->selected = false;
+    if (!state->data)
+    {
+        BSInternal_DirListing *newListing = (BSInternal_DirListing *)BSINTERNAL_CALLOC(1, sizeof(BSInternal_DirListing));
+#if defined(BSINTERNAL_LINUX)
+        newListing->inotifyFD = -1;
+        newListing->watchDescriptor = -1;
+        newListing->watchStopFD = -1;
+#endif
+        state->data = newListing;
+        state->freeData = BSInternal_FreeDirListing;
+    }
     
-    node->prev = sentinel;
-    node->next = sentinel->next;
+    BSInternal_DirListing *result = (BSInternal_DirListing *)state->data;
+    if (BSInternal_FolderChanged(result) ||
+        !bs842_internal_StringCompare(result->folder, folder) ||
+        !bs842_internal_StringCompare(result->fileTypes, fileTypes))
+    {
+        result->valid = false;
+    }
     
-    node->prev->next = node;
-    node->next->prev = node;
+    if (!result->valid)
+    {
+        BSInternal_BeginEnumeration(result, folder, fileTypes);
+    }
     
-    if (node->next != sentinel)
+    // NOTE(bSalmon): Sorting a finished listing moves entries around, so the selection and the entry at the top of the
+    // list are carried over by name
+    char selectedName[MAX_PATH] = {};
+    char anchorName[MAX_PATH] = {};
+    if (result->loading)
     {
-        node->orderInList = (node->next->orderInList + 1);
+        BSInternal_FilterState *filter = &result->filter;
+        bsint_s32 anchorIndex = state->scroll;
+        if (filter->matchesValid)
+        {
+            anchorIndex = (state->scroll < filter->matchCount) ? filter->matches[state->scroll] : -1;
+        }
+        
+        BSInternal_CopyDirEntryName(selectedName, &result->array, state->selected);
+        BSInternal_CopyDirEntryName(anchorName, &result->array, (state->scroll > 0) ? anchorIndex : -1);
     }
-    else
+    
+    if (BSInternal_PollEnumeration(result))
     {
-        node->orderInList = 0;
+        state->selected = BSInternal_FindDirEntry(&result->array, selectedName);
+        
+        if (anchorName[0])
+        {
+            BSInternal_FilterState *filter = &result->filter;
+            BSInternal_UpdateFilter(filter, &result->array, &result->index, result->generation);
+            
+            bsint_s32 anchorIndex = BSInternal_FindDirEntry(&result->array, anchorName);
+            state->scroll = (anchorIndex >= 0) ? anchorIndex : 0;
+            if (filter->matchesValid)
+            {
+                state->scroll = 0;
+                for (bsint_s32 viewIndex = 0; viewIndex < filter->matchCount; ++viewIndex)
+                {
+                    if (filter->matches[viewIndex] == anchorIndex)
+                    {
+                        state->scroll = viewIndex;
+                        break;
+                    }
+                }
+            }
+        }
     }
     
-    return node;
+    return result;
 }
 
-bsint_function void RemoveFindResult(BSInternal_FindResult *removed)
+// NOTE(bSalmon): Forces the named browser to enumerate its folder again next frame
+inline void BS842_Imgui_RefreshFileBrowser(char *title)
 {
-    free(removed->file);
-    
-    removed->prev->next = removed->next;
-    removed->next->prev = removed->prev;
-    
-    removed->next = 0;
-    removed->prev = 0;
-    
-    free(removed);
+    BSInternal_WidgetState *state = BSInternal_GetWidgetState(BSInternal_GetID(title));
+    if (state->data)
+    {
+        ((BSInternal_DirListing *)state->data)->valid = false;
+    }
 }
 
 bsint_function bsint_b32 BS842_ScrollUp(BS842_Prim_SizeSpec sizeSpec)
 {
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_Scroll);
+    BSInternal_BeginWidget();
+    BS842_ImguiID id = BSInternal_GetID("##ScrollUp");
+    
     bsint_b32 result = false;
     
-    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(bs842_internal_info.backBuffer, sizeSpec);
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
     
-    bsint_b32 hovered = (((bs842_internal_info.mouseX >= int_sizeSpec.x1) && (bs842_internal_info.mouseX <= int_sizeSpec.x2)) &&
-                         ((bs842_internal_info.mouseY >= int_sizeSpec.y1) && (bs842_internal_info.mouseY <= int_sizeSpec.y2))) ? true : false;
+    bsint_b32 hovered = BSInternal_HitTest(id, int_sizeSpec);
     
     if (hovered)
     {
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 1.0f, bs842_internal_info.theme.menuItemHovered, bs842_internal_info.theme.menuItemHovered);
-        if (bs842_internal_info.clicked)
+        BSInternal_PushOutlinedBox(sizeSpec, 1.0f, BSINTERNAL_CTX.theme.menuItemHovered, BSINTERNAL_CTX.theme.menuItemHovered);
+        if (BSINTERNAL_CTX.clicked)
         {
             result = true;
         }
     }
     else
     {
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 1.0f, bs842_internal_info.theme.menuBarBackground, bs842_internal_info.theme.menuItemHovered);
+        BSInternal_PushOutlinedBox(sizeSpec, 1.0f, BSINTERNAL_CTX.theme.menuBarBackground, BSINTERNAL_CTX.theme.menuItemHovered);
     }
     
     BS842_Prim_SizeSpec line1 = BS842_FillSizeSpec(sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.2f), sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.5f),
                                                    sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.8f), sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.2f));
     BS842_Prim_SizeSpec line2 = BS842_FillSizeSpec(sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.8f), sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.5f),
                                                    sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.8f), sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.2f));
-    BS842_DrawLine(bs842_internal_info.backBuffer, line1, 1.0f, bs842_internal_info.theme.defaultText);
-    BS842_DrawLine(bs842_internal_info.backBuffer, line2, 1.0f, bs842_internal_info.theme.defaultText);
+    BSInternal_PushLine(line1, 1.0f, BSINTERNAL_CTX.theme.defaultText);
+    BSInternal_PushLine(line2, 1.0f, BSINTERNAL_CTX.theme.defaultText);
+    
+    BSINTERNAL_PROFILE_END(ProfileWidget_Scroll);
+    BSInternal_EndWidget();
     
     return result;
 }
 
 bsint_function bsint_b32 BS842_ScrollDown(BS842_Prim_SizeSpec sizeSpec)
 {
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_Scroll);
+    BSInternal_BeginWidget();
+    BS842_ImguiID id = BSInternal_GetID("##ScrollDown");
+    
     bsint_b32 result = false;
     
-    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(bs842_internal_info.backBuffer, sizeSpec);
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
     
-    bsint_b32 hovered = (((bs842_internal_info.mouseX >= int_sizeSpec.x1) && (bs842_internal_info.mouseX <= int_sizeSpec.x2)) &&
-                         ((bs842_internal_info.mouseY >= int_sizeSpec.y1) && (bs842_internal_info.mouseY <= int_sizeSpec.y2))) ? true : false;
+    bsint_b32 hovered = BSInternal_HitTest(id, int_sizeSpec);
     
     if (hovered)
     {
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 1.0f, bs842_internal_info.theme.menuItemHovered, bs842_internal_info.theme.menuItemHovered);
-        if (bs842_internal_info.clicked)
+        BSInternal_PushOutlinedBox(sizeSpec, 1.0f, BSINTERNAL_CTX.theme.menuItemHovered, BSINTERNAL_CTX.theme.menuItemHovered);
+        if (BSINTERNAL_CTX.clicked)
+        {
+            result = true;
+        }
+    }
+    else
+    {
+        BSInternal_PushOutlinedBox(sizeSpec, 1.0f, BSINTERNAL_CTX.theme.menuBarBackground, BSINTERNAL_CTX.theme.menuItemHovered);
+    }
+    
+    BS842_Prim_SizeSpec line1 = BS842_FillSizeSpec(sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.2f), sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.5f),
+                                                   sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.2f), sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.8f));
+    BS842_Prim_SizeSpec line2 = BS842_FillSizeSpec(sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.8f), sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.5f),
+                                                   sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.2f), sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.8f));
+    BSInternal_PushLine(line1, 1.0f, BSINTERNAL_CTX.theme.defaultText);
+    BSInternal_PushLine(line2, 1.0f, BSINTERNAL_CTX.theme.defaultText);
+    
+    BSINTERNAL_PROFILE_END(ProfileWidget_Scroll);
+    BSInternal_EndWidget();
+    
+    return result;
+}
+
+// NOTE(bSalmon): Navigates into/out of a folder, or sets the chosen file for the caller to read
+bsint_function void BSInternal_OpenBrowserEntry(BS842_Imgui_FileInfo *fileInfo, BSInternal_WidgetState *browserState, char *name, BSInternal_FindResultType type)
+{
+    if (type == FindResult_Folder)
+    {
+        if (BSInternal_IsParentEntry(name))
+        {
+            bsint_s32 sub_i = 1;
+            bsint_s32 sub_old_i = 0;
+            for (char *scan = fileInfo->currFolder; *scan; ++scan, ++sub_i)
+            {
+                if(*scan == BSINTERNAL_PATH_SEPARATOR)
+                {
+                    if (!(*(scan + 1)))
+                    {
+                        char currFolderCopy[MAX_PATH] = {};
+                        bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
+                        bs842_internal_ZeroMem(fileInfo->currFolder, MAX_PATH);
+                        bs842_internal_CopyMem(fileInfo->currFolder, currFolderCopy, sub_old_i);
+                        fileInfo->currFolderLength = sub_old_i;
+                        break;
+                    }
+                    else
+                    {
+                        sub_old_i = sub_i;
+                    }
+                }
+            }
+        }
+        else
         {
-            result = true;
+            char currFolderCopy[MAX_PATH] = {};
+            bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
+            bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, currFolderCopy, bs842_internal_StringLength(name), name, fileInfo->currFolder);
+            fileInfo->currFolderLength += bs842_internal_StringLength(name);
+            
+            bs842_internal_ZeroMem(currFolderCopy, MAX_PATH);
+            bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
+            bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, currFolderCopy, 1, (char *)BSINTERNAL_PATH_SEPARATOR_STRING, fileInfo->currFolder);
+            fileInfo->currFolderLength++;
         }
+        
+        browserState->scroll = 0;
+        browserState->selected = -1;
     }
     else
     {
-        BS842_DrawOutlinedBox(bs842_internal_info.backBuffer, sizeSpec, 1.0f, bs842_internal_info.theme.menuBarBackground, bs842_internal_info.theme.menuItemHovered);
+        bs842_internal_ZeroMem(fileInfo->filename, MAX_PATH);
+        bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, fileInfo->currFolder, bs842_internal_StringLength(name), name, fileInfo->filename);
+        fileInfo->hasBeenRead = false;
     }
-    
-    BS842_Prim_SizeSpec line1 = BS842_FillSizeSpec(sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.2f), sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.5f),
-                                                   sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.2f), sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.8f));
-    BS842_Prim_SizeSpec line2 = BS842_FillSizeSpec(sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.8f), sizeSpec.x1 + ((sizeSpec.x2 - sizeSpec.x1) * 0.5f),
-                                                   sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.2f), sizeSpec.y1 + ((sizeSpec.y2 - sizeSpec.y1) * 0.8f));
-    BS842_DrawLine(bs842_internal_info.backBuffer, line1, 1.0f, bs842_internal_info.theme.defaultText);
-    BS842_DrawLine(bs842_internal_info.backBuffer, line2, 1.0f, bs842_internal_info.theme.defaultText);
-    
-    return result;
 }
 
 bsint_function void BS842_FileBrowser(char *title, char *fileTypes, BS842_Imgui_FileInfo *fileInfo, BS842_Prim_SizeSpec sizeSpec)
 {
-    BSInternal_DrawBasicWindow(bs842_internal_info.backBuffer, title, sizeSpec);
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_FileBrowser);
+    BS842_Imgui_BeginWindow(title, sizeSpec);
+    
+    BSInternal_WidgetState *browserState = BSInternal_GetWidgetState(BSINTERNAL_CTX.currentID);
+    if (!browserState->initialised)
+    {
+        browserState->selected = -1;
+        browserState->scroll = 0;
+        browserState->initialised = true;
+    }
+    
     BS842_Prim_SizeSpec filesSizeSpec = BS842_FillSizeSpec(sizeSpec.x1 + 0.01f, sizeSpec.x2 - 0.01f, sizeSpec.y1 + 0.1f, sizeSpec.y2 - 0.1f);
-    BS842_DrawSolidBox(bs842_internal_info.backBuffer, filesSizeSpec, bs842_internal_info.theme.menuBarBackground);
+    BSInternal_PushSolidBox(filesSizeSpec, BSINTERNAL_CTX.theme.menuBarBackground);
     
-#ifdef _WIN32
     // NOTE(bSalmon): If first time through, set folder to be exe folder
     if (fileInfo->currFolder[0] == '\0')
     {
     char fileFolder[MAX_PATH] = {};
+#ifdef _WIN32
         GetModuleFileNameA(0, fileFolder, sizeof(fileFolder));
+#else
+        if (readlink("/proc/self/exe", fileFolder, sizeof(fileFolder) - 1) <= 0)
+        {
+            if (!getcwd(fileFolder, sizeof(fileFolder) - 2))
+            {
+                fileFolder[0] = '.';
+                fileFolder[1] = '\0';
+            }
+            
+            bsint_s32 cwdLength = bs842_internal_StringLength(fileFolder);
+            fileFolder[cwdLength] = BSINTERNAL_PATH_SEPARATOR;
+            fileFolder[cwdLength + 1] = '\0';
+        }
+#endif
         char *lastSlash = fileFolder;
         bsint_s32 length = 0;
         bsint_s32 savedLength = 0;
 	for (char *scan = fileFolder; *scan; ++scan)
         {
             length++;
-		if(*scan == '\\')
+		if(*scan == BSINTERNAL_PATH_SEPARATOR)
         {
                 lastSlash = scan + 1;
                 savedLength = length;
@@ -705,10 +4829,6 @@ bsint_function void BS842_FileBrowser(char *title, char *fileTypes, BS842_Imgui_
         fileInfo->currFolderLength = savedLength;
     }
     
-#else
-    INTERNAL_ASSERT(false);
-#endif
-    
     // TODO(bSalmon): Separate out current directory for buttons up top
     BSInternal_StringNode stringSentinel;
     stringSentinel.string = 0;
@@ -719,7 +4839,7 @@ bsint_function void BS842_FileBrowser(char *title, char *fileTypes, BS842_Imgui_
     bsint_s32 old_i = 0;
     for (char *scan = fileInfo->currFolder; *scan; ++scan, ++i)
 	{
-		if(*scan == '\\')
+		if(*scan == BSINTERNAL_PATH_SEPARATOR)
         {
             BSInternal_StringNode *node = AddStringNode(&stringSentinel, (i - old_i) + 1);
             bs842_internal_CopyMem(node->string, &fileInfo->currFolder[old_i], (i - old_i) + 1);
@@ -729,27 +4849,17 @@ bsint_function void BS842_FileBrowser(char *title, char *fileTypes, BS842_Imgui_
         }
     }
     
-    bsint_local_persist bsint_s32 lastSelectedOrderInList = -1;
-    bsint_local_persist bsint_s32 topOfCurrList = 0;
-    bsint_b32 isFirstInList = true;
-        BS842_Prim_SizeSpec anchor = {};
+    // NOTE(bSalmon): Each folder button is as wide as its name, the row runs up to the filter box
+    bsint_s32 crumbSpacing = bs842_prim_internal_RoundF32ToS32(0.01f * BSINTERNAL_CTX.backBuffer->width);
+    BS842_Imgui_BeginLayout("##Breadcrumbs", BS842_FillSizeSpec(sizeSpec.x1 + 0.025f, sizeSpec.x2 - 0.21f, sizeSpec.y1 + 0.055f, sizeSpec.y1 + 0.09f), LayoutDirection_Row, 0, crumbSpacing);
     for (BSInternal_StringNode *stringNode = stringSentinel.prev; stringNode != &stringSentinel; stringNode = stringNode->prev)
     {
-        if (isFirstInList)
-        {
-            anchor = BS842_FillSizeSpec(sizeSpec.x1 + 0.025f, (sizeSpec.x1 + 0.025f) + (stringNode->strLength * 0.0075f), sizeSpec.y1 + 0.055f, (sizeSpec.y1 + 0.055f) + 0.035f);
-            isFirstInList = false;
-        }
-        else
-        {
-            anchor =  BS842_FillSizeSpec(anchor.x2 + 0.01f, (anchor.x2 + 0.025f) + (stringNode->strLength * 0.0075f), anchor.y1, anchor.y2);
-        }
-        
+        BS842_Prim_SizeSpec anchor = BS842_Imgui_LayoutText(stringNode->string);
         if (BS842_Button(anchor, stringNode->string))
         {
             bsint_s32 currStringLength = 0;
-            lastSelectedOrderInList = -1;
-            topOfCurrList = 0;
+            browserState->selected = -1;
+            browserState->scroll = 0;
             
             for (BSInternal_StringNode *subStringNode = stringSentinel.prev; subStringNode != &stringSentinel; subStringNode = subStringNode->prev)
             {
@@ -775,252 +4885,595 @@ bsint_function void BS842_FileBrowser(char *title, char *fileTypes, BS842_Imgui_
             }
         }
     }
+    BS842_Imgui_EndLayout();
 
     for (BSInternal_StringNode *stringNode = stringSentinel.next; stringNode != &stringSentinel; stringNode = stringSentinel.next)
     {
         RemoveStringNode(stringNode);
     }
     
-#ifdef _WIN32
-    HANDLE findHandle = INVALID_HANDLE_VALUE;
-    WIN32_FIND_DATA findData = {};
-    char findDir[MAX_PATH] = {};
-    bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, fileInfo->currFolder, 2, "*\0", findDir);
-    findHandle = FindFirstFile(findDir, &findData);
-    INTERNAL_ASSERT(findHandle != INVALID_HANDLE_VALUE);
+    BSInternal_DirListing *listing = BSInternal_GetDirListing(browserState, fileInfo->currFolder, fileTypes);
+    if (browserState->selected >= listing->array.entryCount)
+    {
+        browserState->selected = -1;
+    }
     
-    BSInternal_FindResult findSentinel = {};
-    findSentinel.next = &findSentinel;
-    findSentinel.prev = &findSentinel;
+    // NOTE(bSalmon): Typing only goes to the filter once it's been clicked, until a click lands somewhere else
+    BSInternal_FilterState *filter = &listing->filter;
+    BS842_Prim_SizeSpec filterSizeSpec = BS842_FillSizeSpec(sizeSpec.x2 - 0.2f, sizeSpec.x2 - 0.01f, sizeSpec.y1 + 0.055f, sizeSpec.y1 + 0.09f);
+    BSInternal_SizeSpec int_filterSizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, filterSizeSpec);
+    BS842_ImguiID filterID = BSInternal_GetID("##Filter");
     
-    do
+    BSInternal_HitTest(filterID, int_filterSizeSpec);
+    if (BS842_Imgui_IsActive(filterID))
     {
-        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        for (bsint_s32 inputIndex = 0; inputIndex < BSINTERNAL_CTX.charInputCount; ++inputIndex)
         {
-            if (!((findData.cFileName[0] == '.') && (findData.cFileName[1] == '\0')))
+            char c = BSINTERNAL_CTX.charInput[inputIndex];
+            if (c == '\b')
             {
-            BSInternal_FindResult *findResult = AddFindResult(&findSentinel, FindResult_Folder);
-                bs842_internal_CopyMem(findResult->file, findData.cFileName, MAX_PATH);
+                filter->queryLength -= (filter->queryLength > 0) ? 1 : 0;
             }
+            else if (c == 27)
+            {
+                filter->queryLength = 0;
+            }
+            else if ((c >= ' ') && (c <= '~') && (filter->queryLength < (BSINTERNAL_MAX_FILTER_LENGTH - 1)))
+            {
+                filter->query[filter->queryLength++] = c;
+            }
+            filter->query[filter->queryLength] = '\0';
+            browserState->scroll = 0;
         }
-        else
+    }
+    BSInternal_UpdateFilter(filter, &listing->array, &listing->index, listing->generation);
+    
+    bsint_u32 filterOutline = BS842_Imgui_IsActive(filterID) ? BSINTERNAL_CTX.theme.fileBrowseSelected : BSINTERNAL_CTX.theme.elemOutline;
+    BSInternal_PushOutlinedBox(filterSizeSpec, 1.0f, BSINTERNAL_CTX.theme.menuBarBackground, filterOutline);
+    bsint_s32 filterTextSizeY = (bsint_s32)(((filterSizeSpec.y2 - filterSizeSpec.y1) * BSINTERNAL_CTX.backBuffer->height) * 0.8f);
+    if (filter->queryLength)
+    {
+        BSInternal_PushText(&BSINTERNAL_CTX.fileFontInfo, filter->query, filter->queryLength, (bsint_f32)filterTextSizeY, BSINTERNAL_CTX.theme.defaultText, filterSizeSpec.x1 + 0.0025f, filterSizeSpec.y1 + 0.0025f);
+    }
+    else
+    {
+        BSInternal_PushText(&BSINTERNAL_CTX.fileFontInfo, "Filter", -1, (bsint_f32)filterTextSizeY, BSINTERNAL_CTX.theme.elemOutline, filterSizeSpec.x1 + 0.0025f, filterSizeSpec.y1 + 0.0025f);
+    }
+    
+    // NOTE(bSalmon): Rows index into the filter matches when a filter is set, otherwise straight into the listing
+    bsint_s32 viewCount = filter->matchesValid ? filter->matchCount : listing->array.entryCount;
+    
+    bsint_s32 maxListCount = 25;
+    BS842_Prim_SizeSpec scrollUpSizeSpec = BS842_FillSizeSpec(filesSizeSpec.x2 - 0.025f, filesSizeSpec.x2, filesSizeSpec.y1, filesSizeSpec.y1 + 0.05f);
+    BS842_Prim_SizeSpec scrollDownSizeSpec = BS842_FillSizeSpec(filesSizeSpec.x2 - 0.025f, filesSizeSpec.x2, filesSizeSpec.y2 - 0.05f, filesSizeSpec.y2);
+    BSInternal_PushLine(BS842_FillSizeSpec(filesSizeSpec.x2 - 0.025f, filesSizeSpec.x2 - 0.025f, filesSizeSpec.y1 + 0.05f, filesSizeSpec.y2 - 0.05f), 1.0f, BSINTERNAL_CTX.theme.elemOutline);
+    BSInternal_PushLine(BS842_FillSizeSpec(filesSizeSpec.x2, filesSizeSpec.x2, filesSizeSpec.y1 + 0.05f, filesSizeSpec.y2 - 0.05f), 1.0f, BSINTERNAL_CTX.theme.elemOutline);
+    bsint_s32 scrollTicks = BSINTERNAL_CTX.scrolledDown - BSINTERNAL_CTX.scrolledUp;
+    scrollTicks += BS842_ScrollDown(scrollDownSizeSpec) ? 1 : 0;
+    scrollTicks -= BS842_ScrollUp(scrollUpSizeSpec) ? 1 : 0;
+    for (; (scrollTicks < 0) && (browserState->scroll - maxListCount >= 0); ++scrollTicks)
+    {
+        browserState->scroll -= maxListCount;
+    }
+    for (; (scrollTicks > 0) && (browserState->scroll + maxListCount < viewCount); --scrollTicks)
+    {
+        browserState->scroll += maxListCount;
+    }
+    if (browserState->scroll >= viewCount)
+    {
+        browserState->scroll = 0;
+    }
+    
+    // NOTE(bSalmon): Only the visible window of the sorted listing is laid out
+    bsint_s32 firstVisible = browserState->scroll;
+    bsint_s32 lastVisible = ((firstVisible + maxListCount) < viewCount) ? (firstVisible + maxListCount) : viewCount;
+    bsint_s32 openIndex = -1;
+    
+    bsint_s32 textSizeY = (bsint_s32)(((filesSizeSpec.y2 - filesSizeSpec.y1) * BSINTERNAL_CTX.backBuffer->height) * (1.0f / (bsint_f32)maxListCount));
+    bsint_f32 rowHeight = (bsint_f32)textSizeY / (bsint_f32)BSINTERNAL_CTX.backBuffer->height;
+    for (bsint_s32 viewIndex = firstVisible; viewIndex < lastVisible; ++viewIndex)
+    {
+        bsint_s32 entryIndex = filter->matchesValid ? filter->matches[viewIndex] : viewIndex;
+        BSInternal_DirEntry *entry = &listing->array.entries[entryIndex];
+        char *entryName = listing->array.names + entry->nameOffset;
+        bsint_s32 row = viewIndex - firstVisible;
+        bsint_f32 yPos = filesSizeSpec.y1 + ((rowHeight * row) + 0.0025f);
+        
+        bsint_u32 textColour = (entry->type == FindResult_Folder) ? BSINTERNAL_CTX.theme.fileBrowseFolder : BSINTERNAL_CTX.theme.fileBrowseFile;
+        BS842_Prim_SizeSpec boundBox = BS842_FillSizeSpec(filesSizeSpec.x1, filesSizeSpec.x2 - 0.025f,
+                                                          filesSizeSpec.y1 + (rowHeight * row) + 0.0025f, filesSizeSpec.y1 + (rowHeight * row) + rowHeight);
+        
+        BSInternal_SizeSpec int_boundBox = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, boundBox);
+        
+        bsint_b32 hovered = BSInternal_HitTest(BSInternal_GetID(entryIndex), int_boundBox);
+        
+        if (hovered)
         {
-            bsint_s32 filenameLength = bs842_internal_StringLength(findData.cFileName);
-            char *extension = &findData.cFileName[filenameLength - 4];
-            if (bs842_internal_StringCompare(extension, fileTypes)) // NOTE(bSalmon): Won't work for multiple fileTypes
+            BSInternal_PushSolidBox(boundBox, BSINTERNAL_CTX.theme.fileBrowseSelectedBar);
+            if (BSINTERNAL_CTX.clicked)
+            {
+                browserState->selected = entryIndex;
+            }
+            else if (BSINTERNAL_CTX.dblClicked)
             {
-                BSInternal_FindResult *findResult = AddFindResult(&findSentinel, FindResult_File);
-                bs842_internal_CopyMem(findResult->file, findData.cFileName, MAX_PATH);
+                browserState->selected = entryIndex;
+                openIndex = entryIndex;
             }
+            else
+            {
+                textColour = BSINTERNAL_CTX.theme.fileBrowseInvert;
+            }
+        }
+        
+        if (entryIndex == browserState->selected)
+        {
+            textColour = BSINTERNAL_CTX.theme.fileBrowseSelected;
+            BSInternal_PushSolidBox(boundBox, BSINTERNAL_CTX.theme.fileBrowseSelectedBar);
         }
+        
+        BSInternal_PushText(&BSINTERNAL_CTX.fileFontInfo, entryName, -1, (bsint_f32)textSizeY, textColour, filesSizeSpec.x1 + 0.0025f, yPos);
     }
-    while (FindNextFile(findHandle, &findData) != 0);
-    FindClose(findHandle);
     
-#else
-    INTERNAL_ASSERT(false);
-#endif
+    if (listing->loading)
+    {
+        BSInternal_PushText(&BSINTERNAL_CTX.fileFontInfo, "Loading...", -1, (bsint_f32)textSizeY, BSINTERNAL_CTX.theme.fileBrowseFile, filesSizeSpec.x1 + 0.0025f, filesSizeSpec.y2 + 0.025f);
+    }
+    
+    if (BS842_Button(BS842_FillSizeSpec(filesSizeSpec.x2 - 0.1f, filesSizeSpec.x2, filesSizeSpec.y2 + 0.025f, sizeSpec.y2 - 0.025f), "Open"))
+    {
+        openIndex = browserState->selected;
+    }
     
-    for (BSInternal_FindResult *findResult = findSentinel.prev; findResult != &findSentinel; findResult = findResult->prev, ++i)
+    if (openIndex != -1)
     {
-        if ((findResult->type == FindResult_Folder) && (findResult->next != &findSentinel) && (findResult->next->type != FindResult_Folder))
+        BSInternal_DirEntry *entry = &listing->array.entries[openIndex];
+        if (entry->type == FindResult_Folder)
         {
-            INTERNAL_SWAP(findResult->file, findResult->next->file);
-            INTERNAL_SWAP(findResult->type, findResult->next->type);
-            INTERNAL_SWAP(findResult->orderInList, findResult->next->orderInList);
+            filter->queryLength = 0;
+            filter->query[0] = '\0';
         }
+        BSInternal_OpenBrowserEntry(fileInfo, browserState, listing->array.names + entry->nameOffset, entry->type);
     }
     
-    bsint_s32 maxListCount = 25;
-    BS842_Prim_SizeSpec scrollUpSizeSpec = BS842_FillSizeSpec(filesSizeSpec.x2 - 0.025f, filesSizeSpec.x2, filesSizeSpec.y1, filesSizeSpec.y1 + 0.05f);
-    BS842_Prim_SizeSpec scrollDownSizeSpec = BS842_FillSizeSpec(filesSizeSpec.x2 - 0.025f, filesSizeSpec.x2, filesSizeSpec.y2 - 0.05f, filesSizeSpec.y2);
-    BS842_DrawLine(bs842_internal_info.backBuffer, BS842_FillSizeSpec(filesSizeSpec.x2 - 0.025f, filesSizeSpec.x2 - 0.025f, filesSizeSpec.y1 + 0.05f, filesSizeSpec.y2 - 0.05f), 1.0f, bs842_internal_info.theme.elemOutline);
-    BS842_DrawLine(bs842_internal_info.backBuffer, BS842_FillSizeSpec(filesSizeSpec.x2, filesSizeSpec.x2, filesSizeSpec.y1 + 0.05f, filesSizeSpec.y2 - 0.05f), 1.0f, bs842_internal_info.theme.elemOutline);
-    if ((BS842_ScrollUp(scrollUpSizeSpec) || bs842_internal_info.scrolledUp) && (topOfCurrList - maxListCount >= 0))
+    BSINTERNAL_PROFILE_END(ProfileWidget_FileBrowser);
+    BS842_Imgui_EndWindow();
+}
+
+///////////
+// TABLE //
+///////////
+
+#define BS842_TABLE_MAX_CELL_LENGTH 64
+
+// NOTE(bSalmon): Writes the text for one cell into buffer (bufferSize includes the terminator). Only called for rows on screen
+typedef void BS842_TableCellProvider(void *userData, bsint_s32 row, bsint_s32 column, char *buffer, bsint_s32 bufferSize);
+
+// NOTE(bSalmon): Optional, orders two rows by column, < 0 if rowA comes first. Without one rows sort by cell text
+typedef bsint_s32 BS842_TableRowCompare(void *userData, bsint_s32 column, bsint_s32 rowA, bsint_s32 rowB);
+
+struct BS842_TableColumn
+{
+    char *title;
+    bsint_f32 width; // NOTE(bSalmon): Fraction of the table's width, 0 shares whatever the other columns leave
+};
+
+// NOTE(bSalmon): Text for a cell on screen, kept from the frame before in a slot per screen row mod the row count so
+// scrolling keeps the rows still showing. extentX and length only change when the provider's text does
+struct BSInternal_TableCell
+{
+    bsint_s32 row;
+    bsint_s32 length;
+    bsint_s32 fullLength;
+    bsint_s32 extentX;
+    bsint_s32 columnWidth;
+    char text[BS842_TABLE_MAX_CELL_LENGTH];
+};
+
+struct BSInternal_TableState
+{
+    bsint_s32 sortColumn;
+    bsint_b32 sortDescending;
+    
+    // NOTE(bSalmon): Screen order to caller row. Taken when the sort or the row count changes, not every frame
+    bsint_s32 *order;
+    bsint_s32 orderCount;
+    bsint_b32 orderValid;
+    
+    BSInternal_TableCell *cells;
+    bsint_s32 cellCapacity;
+};
+
+struct BSInternal_TableSortContext
+{
+    BSInternal_TableState *table;
+    BS842_TableRowCompare *compare;
+    void *userData;
+    char *keys;
+};
+
+bsint_function void BSInternal_FreeTableState(void *data)
+{
+    BSInternal_TableState *table = (BSInternal_TableState *)data;
+    free(table->order);
+    free(table->cells);
+    free(table);
+}
+
+inline bsint_b32 BSInternal_TableRowLessEqual(BSInternal_TableSortContext *context, bsint_s32 rowA, bsint_s32 rowB)
+{
+    bsint_s32 compare = 0;
+    if (context->compare)
+    {
+        compare = context->compare(context->userData, context->table->sortColumn, rowA, rowB);
+    }
+    else
+    {
+        compare = BSInternal_NaturalCompare(&context->keys[rowA * BS842_TABLE_MAX_CELL_LENGTH], &context->keys[rowB * BS842_TABLE_MAX_CELL_LENGTH]);
+    }
+    
+    bsint_b32 result = (context->table->sortDescending) ? (compare >= 0) : (compare <= 0);
+    return result;
+}
+
+// NOTE(bSalmon): Same stable bottom up merge as the file browser uses, text keys are only fetched once per row
+bsint_function void BSInternal_SortTable(BSInternal_TableState *table, bsint_s32 rowCount, BS842_TableCellProvider *provider, BS842_TableRowCompare *compare, void *userData)
+{
+    if (rowCount > table->orderCount)
+    {
+        table->order = (bsint_s32 *)BSINTERNAL_REALLOC(table->order, rowCount * sizeof(bsint_s32));
+    }
+    table->orderCount = rowCount;
+    table->orderValid = true;
+    
+    for (bsint_s32 row = 0; row < rowCount; ++row)
     {
-        topOfCurrList -= maxListCount;
+        table->order[row] = row;
     }
-    if ((BS842_ScrollDown(scrollDownSizeSpec) || bs842_internal_info.scrolledDown) && (topOfCurrList + maxListCount <= findSentinel.next->orderInList))
+    if ((table->sortColumn < 0) || (rowCount < 2))
     {
-        topOfCurrList += maxListCount;
+        return;
     }
     
-    i = 0;
-    for (BSInternal_FindResult *findResult = findSentinel.prev; findResult != &findSentinel; findResult = findResult->prev)
+    BSInternal_TableSortContext context = {};
+    context.table = table;
+    context.compare = compare;
+    context.userData = userData;
+    if (!compare)
     {
-        if (findResult->orderInList >= topOfCurrList)
+        context.keys = (char *)BSINTERNAL_MALLOC(rowCount * BS842_TABLE_MAX_CELL_LENGTH);
+        for (bsint_s32 row = 0; row < rowCount; ++row)
         {
-            
-            bsint_s32 textSizeY = (bsint_s32)(((filesSizeSpec.y2 - filesSizeSpec.y1) * bs842_internal_info.backBuffer->height) * (1.0f / (bsint_f32)maxListCount));
-        bsint_f32 yPos = filesSizeSpec.y1 + ((((bsint_f32)textSizeY / (bsint_f32)bs842_internal_info.backBuffer->height) * i) + 0.0025f);
-            
-            if (findResult->orderInList >= (topOfCurrList + maxListCount))
+            char *key = &context.keys[row * BS842_TABLE_MAX_CELL_LENGTH];
+            key[0] = '\0';
+            provider(userData, row, table->sortColumn, key, BS842_TABLE_MAX_CELL_LENGTH);
+            key[BS842_TABLE_MAX_CELL_LENGTH - 1] = '\0';
+        }
+    }
+    
+    bsint_s32 *src = table->order;
+    bsint_s32 *dest = (bsint_s32 *)BSINTERNAL_MALLOC(rowCount * sizeof(bsint_s32));
+    bsint_s32 *scratch = dest;
+    
+    for (bsint_s32 width = 1; width < rowCount; width *= 2)
+    {
+        for (bsint_s32 start = 0; start < rowCount; start += 2 * width)
         {
-            break;
-            }
-            
-            bsint_u32 textColour = (findResult->type == FindResult_Folder) ? bs842_internal_info.theme.fileBrowseFolder : bs842_internal_info.theme.fileBrowseFile;
-            BS842_Prim_SizeSpec boundBox = BS842_FillSizeSpec(filesSizeSpec.x1, filesSizeSpec.x2 - 0.025f,
-                                                              filesSizeSpec.y1 + (((bsint_f32)textSizeY / (bsint_f32)bs842_internal_info.backBuffer->height) * i) + 0.0025f, filesSizeSpec.y1 + (((bsint_f32)textSizeY / (bsint_f32)bs842_internal_info.backBuffer->height) * i) + (((bsint_f32)textSizeY / (bsint_f32)bs842_internal_info.backBuffer->height)));
-            
-            BSInternal_SizeSpec int_boundBox = bs842_internal_ConvertSizeSpec(bs842_internal_info.backBuffer, boundBox);
-            
-            bsint_b32 hovered = (((bs842_internal_info.mouseX >= int_boundBox.x1) && (bs842_internal_info.mouseX <= int_boundBox.x2)) &&
-                                 ((bs842_internal_info.mouseY >= int_boundBox.y1) && (bs842_internal_info.mouseY <= int_boundBox.y2))) ? true : false;
+            bsint_s32 mid = ((start + width) < rowCount) ? (start + width) : rowCount;
+            bsint_s32 end = ((start + 2 * width) < rowCount) ? (start + 2 * width) : rowCount;
             
-            if (hovered)
+            bsint_s32 left = start;
+            bsint_s32 right = mid;
+            for (bsint_s32 out = start; out < end; ++out)
             {
-                BS842_DrawSolidBox(bs842_internal_info.backBuffer, boundBox, bs842_internal_info.theme.fileBrowseSelectedBar);
-                if (bs842_internal_info.clicked)
+                if ((left < mid) && ((right >= end) || BSInternal_TableRowLessEqual(&context, src[left], src[right])))
                 {
-                    findResult->selected = true;
-                    lastSelectedOrderInList = findResult->orderInList;
-                }
-                else if (bs842_internal_info.dblClicked)
-                {
-                    findResult->selected = true;
-                    lastSelectedOrderInList = findResult->orderInList;
-                    if (findResult->type == FindResult_Folder)
-                    {
-                        if (bs842_internal_StringCompare(findResult->file, ".."))
-                        {
-                            bsint_s32 sub_i = 1;
-                            bsint_s32 sub_old_i = 0;
-                            for (char *scan = fileInfo->currFolder; *scan; ++scan, ++sub_i)
-                            {
-                                if(*scan == '\\')
-                                {
-                                    if (!(*(scan + 1)))
-                                    {
-                                        char currFolderCopy[MAX_PATH] = {};
-                                        bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
-                                        bs842_internal_ZeroMem(fileInfo->currFolder, MAX_PATH);
-                                        bs842_internal_CopyMem(fileInfo->currFolder, currFolderCopy, sub_old_i);
-                                        fileInfo->currFolderLength = sub_old_i;
-                                        topOfCurrList = 0;
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        sub_old_i = sub_i;
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            char currFolderCopy[MAX_PATH] = {};
-                            bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
-                            bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, currFolderCopy, bs842_internal_StringLength(findResult->file), findResult->file, fileInfo->currFolder);
-                            fileInfo->currFolderLength += bs842_internal_StringLength(findResult->file);
-                            
-                            bs842_internal_ZeroMem(currFolderCopy, MAX_PATH);
-                            bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
-                            bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, currFolderCopy, 1, "\\", fileInfo->currFolder);
-                            fileInfo->currFolderLength++;
-                            topOfCurrList = 0;
-                        }
-                    }
-                    else
-                    {
-                        bs842_internal_ZeroMem(fileInfo->filename, MAX_PATH);
-                    bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, fileInfo->currFolder, bs842_internal_StringLength(findResult->file), findResult->file, fileInfo->filename);
-                        fileInfo->hasBeenRead = false;
-                    }
+                    dest[out] = src[left++];
                 }
                 else
                 {
-                textColour = bs842_internal_info.theme.fileBrowseInvert;
+                    dest[out] = src[right++];
                 }
             }
-            
-            if (findResult->orderInList == lastSelectedOrderInList)
-            {
-                textColour = bs842_internal_info.theme.fileBrowseSelected;
-                BS842_DrawSolidBox(bs842_internal_info.backBuffer, boundBox, bs842_internal_info.theme.fileBrowseSelectedBar);
-            }
-            
-        unsigned char *textBitmap = (unsigned char *)malloc(bs842_internal_info.backBuffer->pitch * textSizeY);
-        bs842_internal_ZeroMem(textBitmap, bs842_internal_info.backBuffer->pitch * textSizeY);
-        bsint_f32 charX = 0.0f;
-        BS842_CreateTextBitmap(textBitmap, &bs842_internal_info.fileFontInfo, findResult->file, (bsint_f32)textSizeY, bs842_internal_info.backBuffer->width, &charX);
-        BS842_DrawTextBitmap(bs842_internal_info.backBuffer, textBitmap, textColour, charX, filesSizeSpec.x1 + 0.0025f, yPos, bs842_internal_info.backBuffer->width, textSizeY, true);
+        }
         
-            free(textBitmap);
-            
-            ++i;
+        INTERNAL_SWAP(src, dest);
+    }
+    
+    if (src != table->order)
+    {
+        bs842_internal_CopyMem(table->order, src, rowCount * sizeof(bsint_s32));
+    }
+    
+    free(scratch);
+    free(context.keys);
+}
+
+// NOTE(bSalmon): Sorts the named table again next frame. Rows on screen are re-sorted when their text in the sorted
+// column changes, this is for data that changes off screen
+inline void BS842_Imgui_RefreshTable(const char *label)
+{
+    BSInternal_WidgetState *state = BSInternal_GetWidgetState(BSInternal_GetID(label));
+    if (state->data)
+    {
+        ((BSInternal_TableState *)state->data)->orderValid = false;
+    }
+}
+
+// NOTE(bSalmon): Fixed height rows, only the ones on screen are asked for and drawn. Clicking a header sorts by that
+// column, again flips it. Returns the selected row (the caller's index) or -1
+bsint_function bsint_s32 BS842_Table(char *label, BS842_Prim_SizeSpec sizeSpec, BS842_TableColumn *columns, bsint_s32 columnCount, bsint_s32 rowCount,
+                                     BS842_TableCellProvider *provider, void *userData, BS842_TableRowCompare *compare = 0, bsint_s32 rowHeight = 18)
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_Table);
+    BSInternal_BeginWidget();
+    BS842_Imgui_PushID(label);
+    
+    BSInternal_WidgetState *state = BSInternal_GetWidgetState(BSINTERNAL_CTX.currentID);
+    if (!state->initialised)
+    {
+        BSInternal_TableState *newTable = (BSInternal_TableState *)BSINTERNAL_CALLOC(1, sizeof(BSInternal_TableState));
+        newTable->sortColumn = -1;
+        state->data = newTable;
+        state->freeData = BSInternal_FreeTableState;
+        state->selected = -1;
+        state->scroll = 0;
+        state->initialised = true;
+    }
+    BSInternal_TableState *table = (BSInternal_TableState *)state->data;
+    
+    BSInternal_BackBuffer *backBuffer = BSINTERNAL_CTX.backBuffer;
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(backBuffer, sizeSpec);
+    bsint_s32 scrollBarWidth = bs842_prim_internal_RoundF32ToS32(0.025f * backBuffer->width);
+    bsint_s32 tableWidth = (int_sizeSpec.x2 - int_sizeSpec.x1) - scrollBarWidth;
+    bsint_s32 visibleRows = ((int_sizeSpec.y2 - int_sizeSpec.y1) / rowHeight) - 1;
+    if ((tableWidth <= 0) || (visibleRows <= 0))
+    {
+        BS842_Imgui_PopID();
+        BSINTERNAL_PROFILE_END(ProfileWidget_Table);
+        BSInternal_EndWidget();
+        return state->selected;
+    }
+    BSInternal_PushSolidBox(int_sizeSpec, BSINTERNAL_CTX.theme.menuBarBackground);
+    
+    // NOTE(bSalmon): Columns without a width split what's left evenly
+    bsint_f32 fixedWidth = 0.0f;
+    bsint_s32 flexibleCount = 0;
+    for (bsint_s32 column = 0; column < columnCount; ++column)
+    {
+        fixedWidth += columns[column].width;
+        flexibleCount += (columns[column].width > 0.0f) ? 0 : 1;
+    }
+    bsint_f32 flexibleWidth = (flexibleCount && (fixedWidth < 1.0f)) ? ((1.0f - fixedWidth) / flexibleCount) : 0.0f;
+    
+    bsint_s32 *columnX = BSInternal_PushArray(&BSINTERNAL_CTX.frameArena, columnCount + 1, bsint_s32);
+    columnX[0] = int_sizeSpec.x1;
+    for (bsint_s32 column = 0; column < columnCount; ++column)
+    {
+        bsint_f32 width = (columns[column].width > 0.0f) ? columns[column].width : flexibleWidth;
+        columnX[column + 1] = columnX[column] + (bsint_s32)(width * tableWidth);
+    }
+    
+    bsint_f32 lineHeight = (bsint_f32)(bsint_s32)(rowHeight * 0.8f);
+    bsint_s32 textInset = bs842_prim_internal_RoundF32ToS32(0.0025f * backBuffer->width);
+    
+    // NOTE(bSalmon): Header
+    BS842_Imgui_PushID("##Header");
+    for (bsint_s32 column = 0; column < columnCount; ++column)
+    {
+        BSInternal_BeginWidget();
+        BS842_ImguiID headerID = BSInternal_GetID(column);
+        BSInternal_SizeSpec headerRect = BS842_FillSizeSpec(columnX[column], columnX[column + 1], int_sizeSpec.y1, int_sizeSpec.y1 + rowHeight - 1);
+        
+        bsint_b32 hovered = BSInternal_HitTest(headerID, headerRect);
+        if (hovered && BSINTERNAL_CTX.clicked)
+        {
+            table->sortDescending = (table->sortColumn == column) ? !table->sortDescending : false;
+            table->sortColumn = column;
+            table->orderValid = false;
         }
-        else
+        
+        bsint_u32 headerColour = (hovered) ? BSINTERNAL_CTX.theme.menuItemHovered : BSINTERNAL_CTX.theme.elemBackground;
+        BSInternal_PushOutlinedBox(headerRect, 1.0f, headerColour, BSINTERNAL_CTX.theme.elemOutline);
+        
+        bsint_f32 xPos = (bsint_f32)(headerRect.x1 + textInset) / backBuffer->width;
+        bsint_f32 yPos = (bsint_f32)(headerRect.y1 + 1) / backBuffer->height;
+        BSInternal_PushText(&BSINTERNAL_CTX.fontInfo, columns[column].title, -1, lineHeight, BSINTERNAL_CTX.theme.defaultText, xPos, yPos);
+        if (table->sortColumn == column)
         {
-            findResult->selected = false;
+            char arrow[2] = {(table->sortDescending) ? 'v' : '^', '\0'};
+            bsint_f32 arrowX = (bsint_f32)(headerRect.x2 - (textInset * 3)) / backBuffer->width;
+            BSInternal_PushText(&BSINTERNAL_CTX.fontInfo, arrow, 1, lineHeight, BSINTERNAL_CTX.theme.defaultText, arrowX, yPos);
         }
+        BSInternal_EndWidget();
     }
+    BS842_Imgui_PopID();
     
-    if (BS842_Button(BS842_FillSizeSpec(filesSizeSpec.x2 - 0.1f, filesSizeSpec.x2, filesSizeSpec.y2 + 0.025f, sizeSpec.y2 - 0.025f), "Open"))
+    if (!table->orderValid || (table->orderCount != rowCount))
+    {
+        BSInternal_SortTable(table, rowCount, provider, compare, userData);
+    }
+    
+    // NOTE(bSalmon): The body is one hit rect under the scroll buttons, so wheel ticks only go to the table the grid
+    // found under the mouse. They move 3 rows and the buttons a page
+    BSInternal_SizeSpec bodyRect = BS842_FillSizeSpec(int_sizeSpec.x1, int_sizeSpec.x2, int_sizeSpec.y1 + rowHeight, int_sizeSpec.y2);
+    bsint_b32 bodyHovered = BSInternal_HitTest(BSInternal_GetID("##Body"), bodyRect);
+    bsint_f32 scrollX1 = (bsint_f32)(int_sizeSpec.x2 - scrollBarWidth) / backBuffer->width;
+    bsint_f32 bodyY1 = (bsint_f32)bodyRect.y1 / backBuffer->height;
+    bsint_f32 scrollButtonHeight = (bsint_f32)scrollBarWidth / backBuffer->height;
+    BS842_Prim_SizeSpec scrollUpSizeSpec = BS842_FillSizeSpec(scrollX1, sizeSpec.x2, bodyY1, bodyY1 + scrollButtonHeight);
+    BS842_Prim_SizeSpec scrollDownSizeSpec = BS842_FillSizeSpec(scrollX1, sizeSpec.x2, sizeSpec.y2 - scrollButtonHeight, sizeSpec.y2);
+    
+    bsint_s32 scroll = state->scroll;
+    if (bodyHovered)
+    {
+        scroll += 3 * (BSINTERNAL_CTX.scrolledDown - BSINTERNAL_CTX.scrolledUp);
+    }
+    scroll -= BS842_ScrollUp(scrollUpSizeSpec) ? visibleRows : 0;
+    scroll += BS842_ScrollDown(scrollDownSizeSpec) ? visibleRows : 0;
+    scroll = (scroll > (rowCount - visibleRows)) ? (rowCount - visibleRows) : scroll;
+    scroll = (scroll < 0) ? 0 : scroll;
+    state->scroll = scroll;
+    
+    bsint_s32 firstVisible = scroll;
+    bsint_s32 lastVisible = ((firstVisible + visibleRows) < rowCount) ? (firstVisible + visibleRows) : rowCount;
+    
+    // NOTE(bSalmon): Rows don't take the mouse themselves, the one under it comes from where the body was hit
+    bsint_s32 hoveredView = -1;
+    if (bodyHovered && (BSINTERNAL_CTX.mouseX <= (int_sizeSpec.x1 + tableWidth)))
+    {
+        hoveredView = firstVisible + ((BSINTERNAL_CTX.mouseY - bodyRect.y1) / rowHeight);
+    }
+    
+    bsint_s32 cellCount = visibleRows * columnCount;
+    if (cellCount > table->cellCapacity)
+    {
+        table->cells = (BSInternal_TableCell *)BSINTERNAL_REALLOC(table->cells, cellCount * sizeof(BSInternal_TableCell));
+        for (bsint_s32 cellIndex = table->cellCapacity; cellIndex < cellCount; ++cellIndex)
+        {
+            table->cells[cellIndex].row = -1;
+        }
+        table->cellCapacity = cellCount;
+    }
+    
+    char buffer[BS842_TABLE_MAX_CELL_LENGTH];
+    for (bsint_s32 viewIndex = firstVisible; viewIndex < lastVisible; ++viewIndex)
     {
-        if (lastSelectedOrderInList != -1)
+        BSInternal_BeginWidget();
+        bsint_s32 row = table->order[viewIndex];
+        bsint_s32 rowY = bodyRect.y1 + ((viewIndex - firstVisible) * rowHeight);
+        BSInternal_SizeSpec rowRect = BS842_FillSizeSpec(int_sizeSpec.x1, int_sizeSpec.x1 + tableWidth, rowY, rowY + rowHeight - 1);
+        
+        bsint_b32 hovered = (viewIndex == hoveredView);
+        if (hovered && (BSINTERNAL_CTX.clicked || BSINTERNAL_CTX.dblClicked))
+        {
+            state->selected = row;
+        }
+        
+        bsint_u32 textColour = BSINTERNAL_CTX.theme.fileBrowseFile;
+        if (row == state->selected)
+        {
+            BSInternal_PushSolidBox(rowRect, BSINTERNAL_CTX.theme.fileBrowseSelectedBar);
+            textColour = BSINTERNAL_CTX.theme.fileBrowseSelected;
+        }
+        else if (hovered)
         {
-            for (BSInternal_FindResult *findResult = findSentinel.prev; findResult != &findSentinel; findResult = findResult->prev)
+            BSInternal_PushSolidBox(rowRect, BSINTERNAL_CTX.theme.fileBrowseSelectedBar);
+            textColour = BSINTERNAL_CTX.theme.fileBrowseInvert;
+        }
+        
+        for (bsint_s32 column = 0; column < columnCount; ++column)
+        {
+            buffer[0] = '\0';
+            provider(userData, row, column, buffer, BS842_TABLE_MAX_CELL_LENGTH);
+            buffer[BS842_TABLE_MAX_CELL_LENGTH - 1] = '\0';
+            bsint_s32 length = bs842_internal_StringLength(buffer);
+            
+            // NOTE(bSalmon): Only measured when the value or the column changed, text too wide for the column is cut short
+            bsint_s32 columnWidth = (columnX[column + 1] - columnX[column]) - (textInset * 2);
+            BSInternal_TableCell *cell = &table->cells[((viewIndex % visibleRows) * columnCount) + column];
+            if ((cell->row != row) || (cell->fullLength != length) || (cell->columnWidth != columnWidth) ||
+                !bs842_internal_StringCompare(cell->text, buffer))
             {
-                if (findResult->orderInList == lastSelectedOrderInList)
+                // NOTE(bSalmon): A row on screen whose sorted value changed may be out of place now, sorted again next frame
+                if ((column == table->sortColumn) && (cell->row == row) &&
+                    ((cell->fullLength != length) || !bs842_internal_StringCompare(cell->text, buffer)))
+                {
+                    table->orderValid = false;
+                    BS842_Imgui_RequestRedraw();
+                }
+                
+                cell->row = row;
+                cell->fullLength = length;
+                cell->columnWidth = columnWidth;
+                bs842_internal_CopyMem(cell->text, buffer, length + 1);
+                
+                cell->length = length;
+                BS842_MeasureText(&BSINTERNAL_CTX.fileFontInfo, cell->text, cell->length, lineHeight, &cell->extentX);
+                if (cell->extentX > columnWidth)
                 {
-                    if (findResult->type == FindResult_Folder)
+                    bsint_s32 fits = 0;
+                    bsint_s32 tooLong = length;
+                    while ((tooLong - fits) > 1)
                     {
-                        if (bs842_internal_StringCompare(findResult->file, ".."))
+                        bsint_s32 tryLength = (fits + tooLong) / 2;
+                        bsint_s32 tryExtentX = 0;
+                        BS842_MeasureText(&BSINTERNAL_CTX.fileFontInfo, cell->text, tryLength, lineHeight, &tryExtentX);
+                        if (tryExtentX > columnWidth)
                         {
-                            bsint_s32 sub_i = 1;
-                            bsint_s32 sub_old_i = 0;
-                            for (char *scan = fileInfo->currFolder; *scan; ++scan, ++sub_i)
-                            {
-                                if(*scan == '\\')
-                                {
-                                    if (!(*(scan + 1)))
-                                    {
-                                        char currFolderCopy[MAX_PATH] = {};
-                                        bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
-                                        bs842_internal_ZeroMem(fileInfo->currFolder, MAX_PATH);
-                                        bs842_internal_CopyMem(fileInfo->currFolder, currFolderCopy, sub_old_i);
-                                        fileInfo->currFolderLength = sub_old_i;
-                                        topOfCurrList = 0;
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        sub_old_i = sub_i;
-                                    }
-                                }
-                            }
+                            tooLong = tryLength;
                         }
                         else
                         {
-                            char currFolderCopy[MAX_PATH] = {};
-                            bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
-                            bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, currFolderCopy, bs842_internal_StringLength(findResult->file), findResult->file, fileInfo->currFolder);
-                            fileInfo->currFolderLength += bs842_internal_StringLength(findResult->file);
-                            
-                            bs842_internal_ZeroMem(currFolderCopy, MAX_PATH);
-                            bs842_internal_CopyMem(currFolderCopy, fileInfo->currFolder, fileInfo->currFolderLength);
-                            bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, currFolderCopy, 1, "\\", fileInfo->currFolder);
-                            fileInfo->currFolderLength++;
-                            topOfCurrList = 0;
+                            fits = tryLength;
                         }
                     }
-                    else
-                    {
-                        bs842_internal_ZeroMem(fileInfo->filename, MAX_PATH);
-                    bs842_internal_ConcatenateStrings(fileInfo->currFolderLength, fileInfo->currFolder, bs842_internal_StringLength(findResult->file), findResult->file, fileInfo->filename);
-                        fileInfo->hasBeenRead = false;
-                    }
+                    
+                    cell->length = fits;
+                    BS842_MeasureText(&BSINTERNAL_CTX.fileFontInfo, cell->text, cell->length, lineHeight, &cell->extentX);
                 }
             }
+            
+            if (cell->length)
+            {
+                bsint_f32 xPos = (bsint_f32)(columnX[column] + textInset) / backBuffer->width;
+                bsint_f32 yPos = (bsint_f32)(rowY + 1) / backBuffer->height;
+                BSInternal_PushTextView(&BSINTERNAL_CTX.fileFontInfo, cell->text, cell->length, lineHeight, textColour, xPos, yPos, cell->extentX);
+            }
         }
+        BSInternal_EndWidget();
     }
     
-    for (BSInternal_FindResult *findResult = findSentinel.next; findResult != &findSentinel; findResult = findSentinel.next)
+    BS842_Imgui_PopID();
+    BSINTERNAL_PROFILE_END(ProfileWidget_Table);
+    BSInternal_EndWidget();
+    
+    return state->selected;
+}
+
+#ifdef BS842_IMGUI_IMAGES
+///////////
+// IMAGE //
+///////////
+
+// NOTE(bSalmon): Draws the image file at path into sizeSpec, scaled to fill it, or at the size the file is from the top
+// left and cut off at the edges when scaleToFit is false. Each size is decoded once and kept in the image cache, on Linux
+// off the render thread. Returns false and draws nothing until the image is ready, or if it couldn't be loaded. Failed
+// loads are tried again every BSINTERNAL_IMAGE_RETRY_FRAMES frames
+bsint_function bsint_b32 BS842_Image(char *path, BS842_Prim_SizeSpec sizeSpec, bsint_b32 scaleToFit = true)
+{
+    BSINTERNAL_PROFILE_BEGIN(ProfileWidget_Image);
+    BSInternal_BeginWidget();
+    
+    bsint_b32 result = false;
+    
+    BSInternal_SizeSpec int_sizeSpec = bs842_internal_ConvertSizeSpec(BSINTERNAL_CTX.backBuffer, sizeSpec);
+    bsint_s32 rectWidth = int_sizeSpec.x2 - int_sizeSpec.x1;
+    bsint_s32 rectHeight = int_sizeSpec.y2 - int_sizeSpec.y1;
+    if ((rectWidth > 0) && (rectHeight > 0))
     {
-        RemoveFindResult(findResult);
+        BSInternal_ImageEntry *image = BSInternal_GetImage(path, (scaleToFit) ? rectWidth : 0, (scaleToFit) ? rectHeight : 0);
+        result = (BSInternal_LoadAcquire(&image->status) == ImageStatus_Ready);
+        if (result)
+        {
+            bsint_s32 drawWidth = (image->width < rectWidth) ? image->width : rectWidth;
+            bsint_s32 drawHeight = (image->height < rectHeight) ? image->height : rectHeight;
+            BSInternal_SizeSpec bounds = BS842_FillSizeSpec(int_sizeSpec.x1, int_sizeSpec.x1 + drawWidth - 1, int_sizeSpec.y1, int_sizeSpec.y1 + drawHeight - 1);
+            
+            BSInternal_DrawCommand *command = BSInternal_PushDrawCommand(DrawCommand_Image, bounds);
+            command->image = image;
+            BSInternal_HashDrawCommand(command);
+        }
     }
+    
+    BSINTERNAL_PROFILE_END(ProfileWidget_Image);
+    BSInternal_EndWidget();
+    
+    return result;
 }
+#endif
+
+// NOTE(bSalmon): Only for the implementation above, code including the header goes through BS842_Imgui_GetContext
+#undef BSINTERNAL_CTX
 
 #define BS842_IMGUI_H
 #endif // BS842_IMGUI_H
\ No newline at end of file
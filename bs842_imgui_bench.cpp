@@ -0,0 +1,266 @@
+/*
+Project: BS842 Tools
+File: bs842_imgui_bench.cpp
+Author: Brock Salmon
+Notice: (C) Copyright 2021 by Brock Salmon. All Rights Reserved
+Dependencies:
+/ bs842_imgui: https://github.com/bSalmon842/bs842_tools/blob/master/bs842_imgui.h
+*/
+
+/* USAGE
+Headless benchmark for bs842_imgui.h, replays a fixed input trace over a menu bar, a button row, a file browser and a
+large table and prints per-frame and per-widget percentiles from BS842_IMGUI_PROFILE. On Linux:
+g++ -std=c++17 -O2 -I<stb folder> bs842_imgui_bench.cpp -o imgui_bench -lpthread
+./imgui_bench <font.ttf> [frames] [folder]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _MSC_VER
+#define __int8 char
+#define __int32 int
+#endif
+
+#define BS842_IMGUI_PROFILE
+#include "bs842_imgui.h"
+
+// NOTE(bSalmon): The input trace the benchmark replays, looping every BSINTERNAL_BENCH_TRACE_FRAMES frames. Positions
+// are fractions of the backbuffer, the mouse glides from one move to the next over the frames between them
+#define BSINTERNAL_BENCH_TRACE_FRAMES 160
+#define BSINTERNAL_BENCH_WIDTH 1280
+#define BSINTERNAL_BENCH_HEIGHT 720
+#define BSINTERNAL_BENCH_TABLE_ROWS 10000
+
+struct BSInternal_BenchStep
+{
+    bsint_s32 frame;
+    BS842_ImguiEventType type;
+    bsint_f32 x;
+    bsint_f32 y;
+};
+
+bsint_global BSInternal_BenchStep bs842_internal_benchTrace[] =
+{
+    {0, ImguiEvent_MouseMove, 0.3f, 0.3f},
+    {10, ImguiEvent_MouseMove, 0.05f, 0.02f}, // File menu
+    {14, ImguiEvent_Click, 0.0f, 0.0f},
+    {24, ImguiEvent_MouseMove, 0.06f, 0.08f}, // Button row
+    {34, ImguiEvent_MouseMove, 0.4f, 0.08f},
+    {36, ImguiEvent_Click, 0.0f, 0.0f},
+    {50, ImguiEvent_MouseMove, 0.2f, 0.4f}, // Browser list
+    {52, ImguiEvent_ScrollDown, 0.0f, 0.0f},
+    {56, ImguiEvent_ScrollDown, 0.0f, 0.0f},
+    {60, ImguiEvent_ScrollUp, 0.0f, 0.0f},
+    {70, ImguiEvent_MouseMove, 0.2f, 0.6f},
+    {72, ImguiEvent_Click, 0.0f, 0.0f},
+    {90, ImguiEvent_MouseMove, 0.7f, 0.5f}, // Table rows
+    {92, ImguiEvent_ScrollDown, 0.0f, 0.0f},
+    {94, ImguiEvent_ScrollDown, 0.0f, 0.0f},
+    {96, ImguiEvent_ScrollDown, 0.0f, 0.0f},
+    {100, ImguiEvent_Click, 0.0f, 0.0f},
+    {110, ImguiEvent_MouseMove, 0.75f, 0.17f}, // Value header
+    {112, ImguiEvent_Click, 0.0f, 0.0f},
+    {120, ImguiEvent_Click, 0.0f, 0.0f},
+    {130, ImguiEvent_MouseMove, 0.7f, 0.6f},
+    {134, ImguiEvent_ScrollUp, 0.0f, 0.0f},
+    {136, ImguiEvent_ScrollUp, 0.0f, 0.0f},
+    {138, ImguiEvent_ScrollUp, 0.0f, 0.0f},
+    {150, ImguiEvent_MouseMove, 0.3f, 0.3f},
+};
+
+// NOTE(bSalmon): Pushes this frame's events, the mouse moves every frame a move in the trace is under way
+bsint_function void BSInternal_ReplayBenchTrace(bsint_s32 frame)
+{
+    bsint_s32 stepCount = sizeof(bs842_internal_benchTrace) / sizeof(bs842_internal_benchTrace[0]);
+    bsint_s32 traceFrame = frame % BSINTERNAL_BENCH_TRACE_FRAMES;
+    
+    BSInternal_BenchStep *fromMove = 0;
+    BSInternal_BenchStep *toMove = 0;
+    for (bsint_s32 stepIndex = 0; stepIndex < stepCount; ++stepIndex)
+    {
+        BSInternal_BenchStep *step = &bs842_internal_benchTrace[stepIndex];
+        if (step->type == ImguiEvent_MouseMove)
+        {
+            if (step->frame <= traceFrame)
+            {
+                fromMove = step;
+            }
+            else if (!toMove)
+            {
+                toMove = step;
+            }
+        }
+        else if (step->frame == traceFrame)
+        {
+            BSInternal_PushSimpleEvent(step->type);
+        }
+    }
+    
+    if (fromMove && toMove)
+    {
+        bsint_f32 t = (bsint_f32)(traceFrame - fromMove->frame) / (bsint_f32)(toMove->frame - fromMove->frame);
+        bsint_f32 x = fromMove->x + ((toMove->x - fromMove->x) * t);
+        bsint_f32 y = fromMove->y + ((toMove->y - fromMove->y) * t);
+        BS842_Imgui_RegisterMouseMove((bsint_s32)(x * BSINTERNAL_BENCH_WIDTH), (bsint_s32)(y * BSINTERNAL_BENCH_HEIGHT));
+    }
+}
+
+bsint_function void BSInternal_BenchCell(void *userData, bsint_s32 row, bsint_s32 column, char *buffer, bsint_s32 bufferSize)
+{
+    (void)userData;
+    
+    switch (column)
+    {
+        case 0: snprintf(buffer, bufferSize, "Channel %d", row); break;
+        case 1: snprintf(buffer, bufferSize, "%d", (row * 7919) % 10007); break;
+        default: snprintf(buffer, bufferSize, "%s", (row % 3) ? "m/s" : "rpm"); break;
+    }
+}
+
+bsint_function bsint_s32 BSInternal_BenchCompare(void *userData, bsint_s32 column, bsint_s32 rowA, bsint_s32 rowB)
+{
+    (void)userData;
+    
+    bsint_s32 result = (column == 1) ? (((rowA * 7919) % 10007) - ((rowB * 7919) % 10007)) : (rowA - rowB);
+    return result;
+}
+
+// NOTE(bSalmon): The widgets every frame of the benchmark builds, roughly what a telemetry viewer puts on screen
+bsint_function void BSInternal_BenchScene(BS842_Imgui_FileInfo *fileInfo)
+{
+    BS842_Prim_SizeSpec menuBar = BS842_MenuBar();
+    bsint_local_persist bsint_b32 menuClicked[3];
+    BS842_Prim_SizeSpec childAnchor = {};
+    if (BS842_MenuBarItem(menuBar, 0, (char *)"File", &menuClicked[0], &childAnchor))
+    {
+        BS842_TextBox(&childAnchor, (char *)"Open...\nRecent\nSave Layout\nExit", 16.0f);
+    }
+    BS842_MenuBarItem(menuBar, 1, (char *)"View", &menuClicked[1]);
+    BS842_MenuBarItem(menuBar, 2, (char *)"Help", &menuClicked[2]);
+    
+    BS842_Imgui_BeginLayout((char *)"##BenchButtons", BS842_FillSizeSpec(0.02f, 0.98f, 0.05f, 0.11f), LayoutDirection_Row);
+    for (bsint_s32 buttonIndex = 0; buttonIndex < 8; ++buttonIndex)
+    {
+        char label[16];
+        snprintf(label, sizeof(label), "Button %d", buttonIndex);
+        BS842_Button(BS842_Imgui_LayoutItem(140), label);
+    }
+    BS842_Imgui_EndLayout();
+    
+    BS842_FileBrowser((char *)"Browse", (char *)".ibt;.csv;.h", fileInfo, BS842_FillSizeSpec(0.02f, 0.48f, 0.13f, 0.95f));
+    
+    BS842_TableColumn columns[] = {{(char *)"Name", 0.4f}, {(char *)"Value", 0.0f}, {(char *)"Unit", 0.0f}};
+    BS842_Table((char *)"##BenchTable", BS842_FillSizeSpec(0.5f, 0.98f, 0.13f, 0.95f), columns, 3, BSINTERNAL_BENCH_TABLE_ROWS, BSInternal_BenchCell, 0, BSInternal_BenchCompare);
+}
+
+bsint_function void BSInternal_PrintBenchRow(BS842_ImguiProfile *profile, const char *name, bsint_u32 *samples)
+{
+    printf("%-20s %10.1f %10.1f %10.1f %10.1f\n", name,
+           BS842_Imgui_ProfilePercentile(profile, samples, 0.5f) / 1000.0f,
+           BS842_Imgui_ProfilePercentile(profile, samples, 0.9f) / 1000.0f,
+           BS842_Imgui_ProfilePercentile(profile, samples, 0.99f) / 1000.0f,
+           BS842_Imgui_ProfilePercentile(profile, samples, 1.0f) / 1000.0f);
+}
+
+// NOTE(bSalmon): Headless, the imgui draws into a backbuffer in memory and nothing is shown
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <font.ttf> [frames] [folder]\n", argv[0]);
+        return 1;
+    }
+    
+    FILE *fontFile = fopen(argv[1], "rb");
+    if (!fontFile)
+    {
+        printf("could not open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(fontFile, 0, SEEK_END);
+    long fontSize = ftell(fontFile);
+    fseek(fontFile, 0, SEEK_SET);
+    bsint_u8 *font = (bsint_u8 *)malloc(fontSize);
+    bsint_b32 fontRead = (fread(font, 1, fontSize, fontFile) == (size_t)fontSize);
+    fclose(fontFile);
+    
+    bsint_s32 frameCount = (argc > 2) ? atoi(argv[2]) : 1000;
+    
+    BS842_Imgui_FileInfo fileInfo = {};
+    if (argc > 3)
+    {
+        bsint_s32 folderLength = bs842_internal_StringLength(argv[3]);
+        if (folderLength < MAX_PATH - 1)
+        {
+            bs842_internal_CopyMem(fileInfo.currFolder, argv[3], folderLength);
+            if (folderLength && (argv[3][folderLength - 1] != BSINTERNAL_PATH_SEPARATOR))
+            {
+                fileInfo.currFolder[folderLength++] = BSINTERNAL_PATH_SEPARATOR;
+            }
+            fileInfo.currFolderLength = folderLength;
+        }
+    }
+    
+    BSInternal_BackBuffer backBuffer = {};
+    backBuffer.width = BSINTERNAL_BENCH_WIDTH;
+    backBuffer.height = BSINTERNAL_BENCH_HEIGHT;
+    backBuffer.pitch = BSINTERNAL_BENCH_WIDTH * 4;
+    backBuffer.memory = calloc(BSINTERNAL_BENCH_WIDTH * BSINTERNAL_BENCH_HEIGHT, 4);
+    
+    if (!fontRead || (BS842_InitImgui(font, font, &backBuffer, Theme_TTR) != Init_Success))
+    {
+        printf("could not initialise the imgui with %s\n", argv[1]);
+        return 1;
+    }
+    
+    bsint_u32 allocationsBefore = bs842_internal_allocationCount;
+    bsint_u64 start = BSInternal_GetTimestampNs();
+    for (bsint_s32 frame = 0; frame < frameCount; ++frame)
+    {
+        BSInternal_ReplayBenchTrace(frame);
+        
+        BS842_ImguiBegin();
+        BSInternal_BenchScene(&fileInfo);
+        BS842_ImguiEnd();
+    }
+    bsint_f32 totalMs = (BSInternal_GetTimestampNs() - start) / 1000000.0f;
+    bsint_u32 allocationsTotal = bs842_internal_allocationCount - allocationsBefore;
+    
+    BS842_ImguiProfile *profile = BS842_Imgui_GetProfile();
+    bsint_s32 sampleCount = (profile->frameCount < BS842_IMGUI_PROFILE_FRAMES) ? profile->frameCount : BS842_IMGUI_PROFILE_FRAMES;
+    printf("%d frames in %.1f ms, %u allocations, stats over the last %d frames\n\n", frameCount, totalMs, allocationsTotal, sampleCount);
+    
+    printf("%-20s %10s %10s %10s %10s\n", "us per frame", "p50", "p90", "p99", "max");
+    BSInternal_PrintBenchRow(profile, "frame", profile->frameNs);
+    BSInternal_PrintBenchRow(profile, "raster", profile->rasterNs);
+    
+    const char *widgetNames[ProfileWidget_Count] = {"menu bar", "menu item", "text box", "window", "button", "scroll", "file browser", "table", "image"};
+    for (bsint_s32 widget = 0; widget < ProfileWidget_Count; ++widget)
+    {
+        BSInternal_PrintBenchRow(profile, widgetNames[widget], profile->widgetNs[widget]);
+    }
+    
+    printf("\n%-20s %10s %10s %10s\n", "per frame", "p50", "p99", "max");
+    printf("%-20s %10u %10u %10u\n", "allocations",
+           BS842_Imgui_ProfilePercentile(profile, profile->allocations, 0.5f),
+           BS842_Imgui_ProfilePercentile(profile, profile->allocations, 0.99f),
+           BS842_Imgui_ProfilePercentile(profile, profile->allocations, 1.0f));
+    for (bsint_s32 widget = 0; widget < ProfileWidget_Count; ++widget)
+    {
+        bsint_u32 *calls = profile->widgetCalls[widget];
+        char name[32];
+        snprintf(name, sizeof(name), "%s calls", widgetNames[widget]);
+        printf("%-20s %10u %10u %10u\n", name,
+               BS842_Imgui_ProfilePercentile(profile, calls, 0.5f),
+               BS842_Imgui_ProfilePercentile(profile, calls, 0.99f),
+               BS842_Imgui_ProfilePercentile(profile, calls, 1.0f));
+    }
+    
+    BS842_ShutdownImgui();
+    free(backBuffer.memory);
+    free(font);
+    return 0;
+}
@@ -27,6 +27,11 @@ extern "C"
 #ifndef BS842_STRLEN
 #include <string.h>
 #define BS842_STRLEN(string) strlen(string)
+#endif
+    
+#ifndef BS842_MEMCOPY
+#include <string.h>
+#define BS842_MEMCOPY(dest, src, size) memcpy(dest, src, size)
 #endif
     
     // TODO(bSalmon): FOR TESTING ONLY, GUT THE FUNCTIONS FROM STB_TRUETYPE NEEDED INTO THIS FILE
@@ -56,6 +61,26 @@ extern "C"
     
 #ifndef BS842_BPP
 #define BS842_BPP 4
+#endif
+    
+    // NOTE(bSalmon): Closest in pixels automatic ticks are allowed to get
+#ifndef BS842_PLOTTING_MAJOR_TICK_SPACING
+#define BS842_PLOTTING_MAJOR_TICK_SPACING 50
+#endif
+    
+#ifndef BS842_PLOTTING_MINOR_TICK_SPACING
+#define BS842_PLOTTING_MINOR_TICK_SPACING 8
+#endif
+    
+    // NOTE(bSalmon): Capacity a data set gets when it's appended to before it has any storage
+#ifndef BS842_PLOTTING_DEFAULT_CAPACITY
+#define BS842_PLOTTING_DEFAULT_CAPACITY 4096
+#endif
+    
+    // NOTE(bSalmon): Most threads BS842_Plotting_UpdateAll renders on besides the caller's,
+    // define BS842_PLOTTING_NO_THREADS to render everything on the caller's thread
+#ifndef BS842_PLOTTING_MAX_WORKERS
+#define BS842_PLOTTING_MAX_WORKERS 15
 #endif
     
     struct BS842_Internal_V2F
@@ -100,9 +125,19 @@ extern "C"
         PlotOpt_MinorY,
         PlotOpt_MajorY,
         
+        PlotOpt_Decimation,
+        
         PlotOpt_Count,
     };
     
+    // NOTE(bSalmon): How a series with more data than the plot has pixel columns gets reduced before it's drawn
+    enum BS842_PlotDecimation
+    {
+        PlotDecimation_None,
+        PlotDecimation_MinMax,
+        PlotDecimation_LTTB,
+    };
+    
     typedef struct
     {
         int width;
@@ -111,41 +146,84 @@ extern "C"
         void *memory;
     } BS842_Plotting_Internal_BackBuffer;
     
+    // NOTE(bSalmon): One block that a plot's memory of one kind is pushed from. It's only ever reset and refilled as a
+    // whole, so a plot's surfaces or data are always a single allocation no matter how many there are
+    typedef struct
+    {
+        unsigned char *memory;
+        size_t size;
+        size_t used;
+    } BS842_Plotting_Internal_Arena;
+    
+    // NOTE(bSalmon): Ring buffer, the oldest datum is at firstDatum and the series wraps through capacity
     typedef struct
     {
         float *xData;
         float *yData;
         int datumCount;
+        int capacity;
+        int firstDatum;
+        int colour; // 0 uses the plot's default for this data set
     } BS842_DataSet;
     
     typedef struct
     {
         bool enabled;
+        bool dirty;
         BS842_Plotting_Internal_BackBuffer backBuffer;
         
+        // NOTE(bSalmon): Everything but the data, copied into backBuffer at the start of each update
+        BS842_Plotting_Internal_BackBuffer staticLayer;
+        bool staticLayerDirty;
+        
         void *optionValues; // 32bit values
         
         stbtt_fontinfo fontInfo;
         
-        BS842_DataSet data[2];
+        BS842_DataSet *data;
+        int dataSetCount;
+        int dataSetCapacity;
+        
+        // NOTE(bSalmon): Scratch for PlotDecimation_LTTB, the indices of the kept data, one per column
+        int *decimated;
+        int decimatedCapacity;
+        
+        // NOTE(bSalmon): backBuffer, staticLayer and decimated live in surfaceArena, every data set's ring buffer in dataArena
+        BS842_Plotting_Internal_Arena surfaceArena;
+        BS842_Plotting_Internal_Arena dataArena;
     } BS842_Plot;
     
     typedef struct
     {
         bool initialised;
-        BS842_Plot plots[8];
+        
+        unsigned char *fontBuffer;
+        stbtt_fontinfo fontInfo;
+        
+        // NOTE(bSalmon): A plot's handle is its slot, the slot of a destroyed plot goes to the next plot created
+        BS842_Plot **plots;
+        int plotCount;
+        int plotCapacity;
     } BS842_Plotting_Internal_Info;
     
     static BS842_Plotting_Internal_Info bs842_plIntInfo = {};
     
     BSDEF void BS842_Plotting_Init(int plotCount, int plotWidth, int plotHeight, char *fontPath);
+    BSDEF void BS842_Plotting_Shutdown();
+    
+    BSDEF int BS842_Plotting_CreatePlot(int plotWidth, int plotHeight);
+    BSDEF void BS842_Plotting_DestroyPlot(int plotIndex);
     
     BSDEF void BS842_Plotting_ChangePlotOption(int plotIndex, BS842_PlotOption option);
     BSDEF void BS842_Plotting_GetPlotOption(void *result, int plotIndex, BS842_PlotOption option);
     
     BSDEF void BS842_Plotting_PlotData(int plotIndex, s32 dataSetIndex, float *xData, float *yData, int datumCount);
+    BSDEF void BS842_Plotting_SetDataCapacity(int plotIndex, s32 dataSetIndex, int capacity);
+    BSDEF void BS842_Plotting_AppendData(int plotIndex, s32 dataSetIndex, float *xData, float *yData, int datumCount);
+    BSDEF void BS842_Plotting_SetDataColour(int plotIndex, s32 dataSetIndex, int colour);
     
     BSDEF void BS842_Plotting_UpdatePlot(int plotIndex);
+    BSDEF void BS842_Plotting_UpdateAll();
     BSDEF void BS842_Plotting_ResizePlot(int plotIndex, int width, int height);
     BSDEF void BS842_Plotting_GetPlotMemory(int plotIndex, void *destMem, int destPitch);
     
@@ -158,6 +236,49 @@ extern "C"
 
 #ifdef BS842_PLOTTING_IMPLEMENTATION
 
+#ifndef BS842_PLOTTING_NO_THREADS
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#endif
+
+// NOTE(bSalmon): Workers sleep on workReady until generation moves on, then they and the thread that called UpdateAll
+// take plots off jobs through nextJob until it runs out. The caller waits on workDone for the last worker to finish
+typedef struct
+{
+    bool running;
+    int workerCount;
+    
+    int *jobs;
+    int jobCapacity;
+    int jobCount;
+    volatile int nextJob;
+    
+#ifndef BS842_PLOTTING_NO_THREADS
+#ifdef _WIN32
+    HANDLE threads[BS842_PLOTTING_MAX_WORKERS];
+    SRWLOCK lock;
+    CONDITION_VARIABLE workReady;
+    CONDITION_VARIABLE workDone;
+#else
+    pthread_t threads[BS842_PLOTTING_MAX_WORKERS];
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+#endif
+#endif
+    
+    // NOTE(bSalmon): Only touched with the lock held
+    bool quit;
+    unsigned int generation;
+    int busyWorkers;
+} BS842_Plotting_Internal_WorkerPool;
+
+static BS842_Plotting_Internal_WorkerPool bs842_plWorkerPool = {};
+
 BSDEF unsigned char BS842_Internal_Lerp(unsigned char a, unsigned char b, float t)
 {
     unsigned char result = (unsigned char)((1.0f - t) * a + t * b);
@@ -244,45 +365,114 @@ BSDEF void BS842_Internal_DrawText(BS842_Plotting_Internal_BackBuffer *backBuffe
         
         row += backBuffer->pitch;
     }
+    
+    BS842_MEMFREE(textBitmap);
 }
 
-BSDEF void BS842_Internal_GetMarks(int *marksCount, float **marks, float minVal, float maxVal, float modVal)
+BSDEF int BS842_Internal_GetValueInMappedRanges(float inValue, float inMin, float inMax, int mapMin, int mapMax)
 {
-    for (float val = minVal; val < maxVal; val += 1.0f)
+    int result = 0;
+    
+    double slope = 1.0 * ((double)mapMax - (double)mapMin) / (inMax - inMin);
+    result = (int)(((double)mapMin + slope * (inValue - inMin)) + 0.5);
+    
+    return result;
+}
+
+// NOTE(bSalmon): Rounds up to the nearest 1, 2, 5 or 10 times a power of ten
+BSDEF float BS842_Internal_NiceNumber(float value)
+{
+    float exponent = (float)floor(log10(value));
+    float power = (float)pow(10.0, exponent);
+    float fraction = value / power;
+    
+    float niceFraction = 10.0f;
+    if (fraction <= 1.0f)
     {
-        double check = BS842_FMOD(val, modVal);
-        if (check == 0.000)
-        {
-            (*marksCount)++;
-        }
+        niceFraction = 1.0f;
+    }
+    else if (fraction <= 2.0f)
+    {
+        niceFraction = 2.0f;
+    }
+    else if (fraction <= 5.0f)
+    {
+        niceFraction = 5.0f;
     }
     
-    if (*marksCount > 0)
+    float result = niceFraction * power;
+    return result;
+}
+
+// NOTE(bSalmon): A step of 0 or less picks the smallest nice step that keeps ticks minSpacing pixels apart, as does a
+// given step that would put ticks closer than that
+BSDEF float BS842_Internal_GetTickStep(float minVal, float maxVal, float step, int pixelLength, int minSpacing)
+{
+    float range = (float)fabs(maxVal - minVal);
+    if (range <= 0.0f || pixelLength <= 0)
     {
-        *marks = (float *)BS842_MEMALLOC(sizeof(float) * *marksCount);
+        return 0.0f;
     }
     
-    int markIndex = 0;
-    for (float val = minVal; val < maxVal; val += 1.0f)
+    float minStep = (range * (float)minSpacing) / (float)pixelLength;
+    float result = step;
+    if (result <= 0.0f || result < minStep)
     {
-        double check = BS842_FMOD(val, modVal);
-        if (check == 0.000)
-        {
-            (*marks)[markIndex++] = val;
-        }
+        result = BS842_Internal_NiceNumber(minStep);
     }
+    
+    return result;
 }
 
-BSDEF int BS842_Internal_GetValueInMappedRanges(float inValue, float inMin, float inMax, int mapMin, int mapMax)
+// NOTE(bSalmon): Minor ticks split a nice major step into nice parts, 1 into fifths, 2 into quarters, 5 into fifths
+BSDEF float BS842_Internal_GetMinorStep(float majorStep)
+{
+    float power = (float)pow(10.0, floor(log10(majorStep)));
+    float fraction = majorStep / power;
+    
+    float result = (fraction > 1.5f && fraction < 2.5f) ? majorStep / 4.0f : majorStep / 5.0f;
+    return result;
+}
+
+// NOTE(bSalmon): Ticks are first + (index * step), everything from minVal to maxVal inclusive. O(1), no walking the range
+BSDEF int BS842_Internal_GetTicks(float *first, float minVal, float maxVal, float step)
 {
     int result = 0;
+    *first = 0.0f;
     
-    double slope = 1.0 * ((double)mapMax - (double)mapMin) / (inMax - inMin);
-    result = (int)(((double)mapMin + slope * (inValue - inMin)) + 0.5);
+    if (step > 0.0f && maxVal > minVal)
+    {
+        float epsilon = step * 0.0001f;
+        *first = (float)ceil((minVal - epsilon) / step) * step;
+        result = (int)floor((maxVal + epsilon - *first) / step) + 1;
+        if (result < 0)
+        {
+            result = 0;
+        }
+    }
     
     return result;
 }
 
+// NOTE(bSalmon): As many decimals as the step has significant ones, so 2.5 gets 1 and 0.25 gets 2, up to 6
+BSDEF void BS842_Internal_FormatTick(char *text, int textSize, float value, float step)
+{
+    int decimals = 0;
+    double scaledStep = fabs(step);
+    while (decimals < 6 && fabs(scaledStep - floor(scaledStep + 0.5)) > scaledStep * 0.0001)
+    {
+        scaledStep *= 10.0;
+        ++decimals;
+    }
+    
+    if (fabs(value) < step * 0.0001f)
+    {
+        value = 0.0f;
+    }
+    
+    snprintf(text, textSize, "%.*f", decimals, value);
+}
+
 BSDEF void BS842_Internal_DrawDottedHorizontalLine(BS842_Plotting_Internal_BackBuffer *backBuffer, int xLeft, int xRight, int y, int colour)
 {
     if (y >= 0 && y < backBuffer->height)
@@ -375,73 +565,415 @@ BSDEF void BS842_Internal_DrawBresenhamLine(BS842_Plotting_Internal_BackBuffer *
     }
 }
 
-BSDEF void BS842_Plotting_Init(int plotCount, int plotWidth, int plotHeight, char *fontPath)
+BSDEF int BS842_Internal_DatumIndex(BS842_DataSet *dataSet, int point)
 {
-    BS842_ASSERT(!bs842_plIntInfo.initialised);
+    int result = dataSet->firstDatum + point;
+    if (result >= dataSet->capacity)
+    {
+        result -= dataSet->capacity;
+    }
     
-    for (int plotIndex = 0; plotIndex < plotCount; ++plotIndex)
+    return result;
+}
+
+BSDEF void BS842_Internal_DrawSeries(BS842_Plotting_Internal_BackBuffer *backBuffer, BS842_DataSet *dataSet, BS842_Internal_V2F minVal, BS842_Internal_V2F maxVal,
+                                     BS842_Internal_V2I plotMin, BS842_Internal_V2I plotMax, int colour)
+{
+    BS842_Internal_V2I prevMapped = {0, 0};
+    int datumIndex = dataSet->firstDatum;
+    for (int point = 0; point < dataSet->datumCount; ++point)
     {
-        BS842_Plot *currPlot = &bs842_plIntInfo.plots[plotIndex];
+        BS842_Internal_V2I mapped =
+        {BS842_Internal_GetValueInMappedRanges(dataSet->xData[datumIndex], minVal.x, maxVal.x, plotMin.x, plotMax.x),
+            BS842_Internal_GetValueInMappedRanges(dataSet->yData[datumIndex], minVal.y, maxVal.y, plotMin.y, plotMax.y)};
         
-        currPlot->enabled = true;
+        if (point > 0)
+        {
+            BS842_Internal_DrawBresenhamLine(backBuffer, prevMapped, mapped, plotMin, plotMax, 1.0f, colour);
+        }
         
-        currPlot->backBuffer.width = plotWidth;
-        currPlot->backBuffer.height = plotHeight;
-        currPlot->backBuffer.pitch = plotWidth * BS842_BPP;
-        currPlot->backBuffer.memory = BS842_MEMALLOC(currPlot->backBuffer.height * currPlot->backBuffer.pitch);
+        prevMapped = mapped;
+        if (++datumIndex == dataSet->capacity)
+        {
+            datumIndex = 0;
+        }
+    }
+}
+
+// NOTE(bSalmon): Collapses every run of data that lands in the same pixel column into a vertical span from its min to
+// its max, joined to the neighbouring columns through its first and last datum. Peaks stay visible and the line count is
+// bounded by the plot width instead of the data count. Works in one pass with no scratch memory
+BSDEF void BS842_Internal_DrawSeriesMinMax(BS842_Plotting_Internal_BackBuffer *backBuffer, BS842_DataSet *dataSet, BS842_Internal_V2F minVal, BS842_Internal_V2F maxVal,
+                                           BS842_Internal_V2I plotMin, BS842_Internal_V2I plotMax, int colour)
+{
+    int columnX = 0;
+    int firstY = 0;
+    int lastY = 0;
+    int minY = 0;
+    int maxY = 0;
+    
+    BS842_Internal_V2I prevLast = {0, 0};
+    bool hasPrev = false;
+    
+    int datumIndex = dataSet->firstDatum;
+    for (int point = 0; point <= dataSet->datumCount; ++point)
+    {
+        BS842_Internal_V2I mapped = {0, 0};
+        if (point < dataSet->datumCount)
+        {
+            mapped.x = BS842_Internal_GetValueInMappedRanges(dataSet->xData[datumIndex], minVal.x, maxVal.x, plotMin.x, plotMax.x);
+            mapped.y = BS842_Internal_GetValueInMappedRanges(dataSet->yData[datumIndex], minVal.y, maxVal.y, plotMin.y, plotMax.y);
+            
+            if (++datumIndex == dataSet->capacity)
+            {
+                datumIndex = 0;
+            }
+            
+            if (point > 0 && mapped.x == columnX)
+            {
+                lastY = mapped.y;
+                if (mapped.y < minY) { minY = mapped.y; }
+                if (mapped.y > maxY) { maxY = mapped.y; }
+                continue;
+            }
+        }
         
-        unsigned char* fontBuffer;
-        int fontSize = 0;
+        if (point > 0)
+        {
+            if (hasPrev)
+            {
+                BS842_Internal_DrawBresenhamLine(backBuffer, prevLast, {columnX, firstY}, plotMin, plotMax, 1.0f, colour);
+            }
+            
+            if (minY != maxY)
+            {
+                BS842_Internal_DrawBresenhamLine(backBuffer, {columnX, minY}, {columnX, maxY}, plotMin, plotMax, 1.0f, colour);
+            }
+            
+            prevLast = {columnX, lastY};
+            hasPrev = true;
+        }
         
-        FILE* fontFile = fopen(fontPath, "rb");
-        fseek(fontFile, 0, SEEK_END);
-        fontSize = ftell(fontFile); /* how long is the file ? */
-        fseek(fontFile, 0, SEEK_SET); /* reset */
+        columnX = mapped.x;
+        firstY = lastY = minY = maxY = mapped.y;
+    }
+}
+
+// NOTE(bSalmon): Largest-Triangle-Three-Buckets, keeps targetCount data picked for the visual area they carry.
+// Smoother looking than min/max but can drop single sample spikes
+BSDEF void BS842_Internal_DrawSeriesLTTB(BS842_Plotting_Internal_BackBuffer *backBuffer, BS842_DataSet *dataSet, BS842_Internal_V2F minVal, BS842_Internal_V2F maxVal,
+                                         BS842_Internal_V2I plotMin, BS842_Internal_V2I plotMax, int colour, int *kept, int targetCount)
+{
+    int datumCount = dataSet->datumCount;
+    float bucketSize = (float)(datumCount - 2) / (float)(targetCount - 2);
+    
+    int keptCount = 0;
+    int a = 0;
+    kept[keptCount++] = BS842_Internal_DatumIndex(dataSet, 0);
+    
+    for (int bucket = 0; bucket < targetCount - 2; ++bucket)
+    {
+        int avgStart = (int)((bucket + 1) * bucketSize) + 1;
+        int avgEnd = (int)((bucket + 2) * bucketSize) + 1;
+        if (avgEnd > datumCount)
+        {
+            avgEnd = datumCount;
+        }
         
-        fontBuffer = (unsigned char *)BS842_MEMALLOC(fontSize);
-        fread(fontBuffer, fontSize, 1, fontFile);
-        fclose(fontFile);
+        float avgX = 0.0f;
+        float avgY = 0.0f;
+        for (int point = avgStart; point < avgEnd; ++point)
+        {
+            int datumIndex = BS842_Internal_DatumIndex(dataSet, point);
+            avgX += dataSet->xData[datumIndex];
+            avgY += dataSet->yData[datumIndex];
+        }
+        avgX /= (float)(avgEnd - avgStart);
+        avgY /= (float)(avgEnd - avgStart);
         
-        /* prepare font */
-        bool fontInitResult = false;
-        fontInitResult = stbtt_InitFont(&currPlot->fontInfo, fontBuffer, 0);
-        BS842_ASSERT(fontInitResult);
+        int aIndex = BS842_Internal_DatumIndex(dataSet, a);
+        float aX = dataSet->xData[aIndex];
+        float aY = dataSet->yData[aIndex];
         
-        currPlot->optionValues = BS842_MEMALLOC(sizeof(int) * PlotOpt_Count);
-        int *intOptions = (int *)currPlot->optionValues;
-        float *floatOptions = (float *)currPlot->optionValues;
-        floatOptions[PlotOpt_MinValX] = 0.0f;
-        floatOptions[PlotOpt_MaxValX] = 100.0f;
-        floatOptions[PlotOpt_MinValY] = 0.0f;
-        floatOptions[PlotOpt_MaxValY] = 100.0f;
+        int rangeStart = (int)(bucket * bucketSize) + 1;
+        int rangeEnd = (int)((bucket + 1) * bucketSize) + 1;
         
-        intOptions[PlotOpt_Colour1] = 0xFFFF0000;
-        intOptions[PlotOpt_Colour2] = 0xFF00FF00;
-        intOptions[PlotOpt_ColourBack] = 0xFFDDDDDD;
-        intOptions[PlotOpt_ColourSub] = 0xFF888888;
-        intOptions[PlotOpt_ColourMargin] = 0xFFBBBBBB;
-        intOptions[PlotOpt_ColourBorders] = 0xFF000000;
+        float maxArea = -1.0f;
+        int maxPoint = rangeStart;
+        for (int point = rangeStart; point < rangeEnd; ++point)
+        {
+            int datumIndex = BS842_Internal_DatumIndex(dataSet, point);
+            float area = (float)fabs((aX - avgX) * (dataSet->yData[datumIndex] - aY) - (aX - dataSet->xData[datumIndex]) * (avgY - aY));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                maxPoint = point;
+            }
+        }
         
-        intOptions[PlotOpt_MarginLeft] = 75;
-        intOptions[PlotOpt_MarginRight] = 15;
-        intOptions[PlotOpt_MarginBottom] = 30;
-        intOptions[PlotOpt_MarginTop] = 15;
+        kept[keptCount++] = BS842_Internal_DatumIndex(dataSet, maxPoint);
+        a = maxPoint;
+    }
+    
+    kept[keptCount++] = BS842_Internal_DatumIndex(dataSet, datumCount - 1);
+    
+    BS842_Internal_V2I prevMapped = {0, 0};
+    for (int keptIndex = 0; keptIndex < keptCount; ++keptIndex)
+    {
+        BS842_Internal_V2I mapped =
+        {BS842_Internal_GetValueInMappedRanges(dataSet->xData[kept[keptIndex]], minVal.x, maxVal.x, plotMin.x, plotMax.x),
+            BS842_Internal_GetValueInMappedRanges(dataSet->yData[kept[keptIndex]], minVal.y, maxVal.y, plotMin.y, plotMax.y)};
         
-        // TODO(bSalmon): Should this be percentage or value based? (Value based for now)
-        floatOptions[PlotOpt_MinorX] = 5.0f;
-        floatOptions[PlotOpt_MajorX] = 10.0f;
-        floatOptions[PlotOpt_MinorY] = 5.0f;
-        floatOptions[PlotOpt_MajorY] = 25.0f;
+        if (keptIndex > 0)
+        {
+            BS842_Internal_DrawBresenhamLine(backBuffer, prevMapped, mapped, plotMin, plotMax, 1.0f, colour);
+        }
         
+        prevMapped = mapped;
+    }
+}
+
+// NOTE(bSalmon): Past Colour1 and Colour2, data sets without their own colour cycle through these
+static unsigned int bs842_plDataSetColours[] = {0xFF0000FF, 0xFFFF8000, 0xFF8000FF, 0xFF00A0A0, 0xFFA0A000, 0xFFFF00FF};
+
+BSDEF void BS842_Internal_ReserveArena(BS842_Plotting_Internal_Arena *arena, size_t size)
+{
+    if (arena->size < size)
+    {
+        if (arena->memory) { BS842_MEMFREE(arena->memory); }
+        arena->memory = (unsigned char *)BS842_MEMALLOC(size);
+        arena->size = size;
     }
     
+    arena->used = 0;
+}
+
+BSDEF void *BS842_Internal_PushSize(BS842_Plotting_Internal_Arena *arena, size_t size)
+{
+    BS842_ASSERT(arena->used + size <= arena->size);
+    
+    void *result = arena->memory + arena->used;
+    arena->used += size;
+    return result;
+}
+
+BSDEF void BS842_Internal_FreeArena(BS842_Plotting_Internal_Arena *arena)
+{
+    if (arena->memory) { BS842_MEMFREE(arena->memory); }
+    *arena = {};
+}
+
+BSDEF BS842_Plot *BS842_Internal_GetPlot(int plotIndex)
+{
+    BS842_ASSERT(bs842_plIntInfo.initialised && plotIndex >= 0 && plotIndex < bs842_plIntInfo.plotCount);
+    
+    BS842_Plot *result = bs842_plIntInfo.plots[plotIndex];
+    BS842_ASSERT(result && result->enabled);
+    return result;
+}
+
+// NOTE(bSalmon): Both surfaces and the decimation scratch are carved from one block, only reallocated when it grows
+BSDEF void BS842_Internal_AllocSurfaces(BS842_Plot *plot, int width, int height)
+{
+    int pitch = width * BS842_BPP;
+    size_t surfaceSize = (size_t)height * pitch;
+    BS842_Internal_ReserveArena(&plot->surfaceArena, (surfaceSize * 2) + (width * sizeof(int)));
+    
+    plot->backBuffer.width = width;
+    plot->backBuffer.height = height;
+    plot->backBuffer.pitch = pitch;
+    plot->backBuffer.memory = BS842_Internal_PushSize(&plot->surfaceArena, surfaceSize);
+    
+    plot->staticLayer = plot->backBuffer;
+    plot->staticLayer.memory = BS842_Internal_PushSize(&plot->surfaceArena, surfaceSize);
+    plot->staticLayerDirty = true;
+    plot->dirty = true;
+    
+    plot->decimated = (int *)BS842_Internal_PushSize(&plot->surfaceArena, width * sizeof(int));
+    plot->decimatedCapacity = width;
+}
+
+BSDEF int BS842_Plotting_CreatePlot(int plotWidth, int plotHeight)
+{
+    BS842_ASSERT(bs842_plIntInfo.initialised);
+    
+    int plotIndex = 0;
+    while (plotIndex < bs842_plIntInfo.plotCount && bs842_plIntInfo.plots[plotIndex])
+    {
+        ++plotIndex;
+    }
+    
+    if (plotIndex == bs842_plIntInfo.plotCapacity)
+    {
+        int newCapacity = bs842_plIntInfo.plotCapacity ? bs842_plIntInfo.plotCapacity * 2 : 8;
+        BS842_Plot **newPlots = (BS842_Plot **)BS842_MEMALLOC(newCapacity * sizeof(BS842_Plot *));
+        if (bs842_plIntInfo.plots)
+        {
+            BS842_MEMCOPY(newPlots, bs842_plIntInfo.plots, bs842_plIntInfo.plotCapacity * sizeof(BS842_Plot *));
+            BS842_MEMFREE(bs842_plIntInfo.plots);
+        }
+        
+        bs842_plIntInfo.plots = newPlots;
+        bs842_plIntInfo.plotCapacity = newCapacity;
+    }
+    
+    if (plotIndex == bs842_plIntInfo.plotCount)
+    {
+        ++bs842_plIntInfo.plotCount;
+    }
+    
+    BS842_Plot *currPlot = (BS842_Plot *)BS842_MEMALLOC(sizeof(BS842_Plot));
+    bs842_plIntInfo.plots[plotIndex] = currPlot;
+    
+    currPlot->enabled = true;
+    currPlot->fontInfo = bs842_plIntInfo.fontInfo;
+    
+    BS842_Internal_AllocSurfaces(currPlot, plotWidth, plotHeight);
+    
+    currPlot->optionValues = BS842_MEMALLOC(sizeof(int) * PlotOpt_Count);
+    int *intOptions = (int *)currPlot->optionValues;
+    float *floatOptions = (float *)currPlot->optionValues;
+    floatOptions[PlotOpt_MinValX] = 0.0f;
+    floatOptions[PlotOpt_MaxValX] = 100.0f;
+    floatOptions[PlotOpt_MinValY] = 0.0f;
+    floatOptions[PlotOpt_MaxValY] = 100.0f;
+    
+    intOptions[PlotOpt_Colour1] = 0xFFFF0000;
+    intOptions[PlotOpt_Colour2] = 0xFF00FF00;
+    intOptions[PlotOpt_ColourBack] = 0xFFDDDDDD;
+    intOptions[PlotOpt_ColourSub] = 0xFF888888;
+    intOptions[PlotOpt_ColourMargin] = 0xFFBBBBBB;
+    intOptions[PlotOpt_ColourBorders] = 0xFF000000;
+    
+    intOptions[PlotOpt_MarginLeft] = 75;
+    intOptions[PlotOpt_MarginRight] = 15;
+    intOptions[PlotOpt_MarginBottom] = 30;
+    intOptions[PlotOpt_MarginTop] = 15;
+    
+    // NOTE(bSalmon): Tick steps are in values. 0, or a step that would crowd the ticks for the range and plot size, picks
+    // a nice step instead
+    floatOptions[PlotOpt_MinorX] = 5.0f;
+    floatOptions[PlotOpt_MajorX] = 10.0f;
+    floatOptions[PlotOpt_MinorY] = 5.0f;
+    floatOptions[PlotOpt_MajorY] = 25.0f;
+    
+    intOptions[PlotOpt_Decimation] = PlotDecimation_MinMax;
+    
+    return plotIndex;
+}
+
+BSDEF void BS842_Plotting_DestroyPlot(int plotIndex)
+{
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
+    
+    BS842_Internal_FreeArena(&plot->surfaceArena);
+    BS842_Internal_FreeArena(&plot->dataArena);
+    if (plot->data) { BS842_MEMFREE(plot->data); }
+    BS842_MEMFREE(plot->optionValues);
+    BS842_MEMFREE(plot);
+    
+    bs842_plIntInfo.plots[plotIndex] = 0;
+}
+
+// NOTE(bSalmon): Loads the font every plot shares and creates plotCount plots with the handles 0 to plotCount - 1
+BSDEF void BS842_Plotting_Init(int plotCount, int plotWidth, int plotHeight, char *fontPath)
+{
+    BS842_ASSERT(!bs842_plIntInfo.initialised);
+    
+    int fontSize = 0;
+    
+    FILE* fontFile = fopen(fontPath, "rb");
+    fseek(fontFile, 0, SEEK_END);
+    fontSize = ftell(fontFile); /* how long is the file ? */
+    fseek(fontFile, 0, SEEK_SET); /* reset */
+    
+    bs842_plIntInfo.fontBuffer = (unsigned char *)BS842_MEMALLOC(fontSize);
+    fread(bs842_plIntInfo.fontBuffer, fontSize, 1, fontFile);
+    fclose(fontFile);
+    
+    /* prepare font */
+    bool fontInitResult = false;
+    fontInitResult = stbtt_InitFont(&bs842_plIntInfo.fontInfo, bs842_plIntInfo.fontBuffer, 0);
+    BS842_ASSERT(fontInitResult);
+    
     bs842_plIntInfo.initialised = true;
+    
+    for (int plotIndex = 0; plotIndex < plotCount; ++plotIndex)
+    {
+        BS842_Plotting_CreatePlot(plotWidth, plotHeight);
+    }
+}
+
+BSDEF void BS842_Internal_StopWorkers()
+{
+    BS842_Plotting_Internal_WorkerPool *pool = &bs842_plWorkerPool;
+    
+#ifndef BS842_PLOTTING_NO_THREADS
+    if (pool->running)
+    {
+#ifdef _WIN32
+        AcquireSRWLockExclusive(&pool->lock);
+        pool->quit = true;
+        WakeAllConditionVariable(&pool->workReady);
+        ReleaseSRWLockExclusive(&pool->lock);
+        
+        for (int workerIndex = 0; workerIndex < pool->workerCount; ++workerIndex)
+        {
+            WaitForSingleObject(pool->threads[workerIndex], INFINITE);
+            CloseHandle(pool->threads[workerIndex]);
+        }
+#else
+        pthread_mutex_lock(&pool->lock);
+        pool->quit = true;
+        pthread_cond_broadcast(&pool->workReady);
+        pthread_mutex_unlock(&pool->lock);
+        
+        for (int workerIndex = 0; workerIndex < pool->workerCount; ++workerIndex)
+        {
+            pthread_join(pool->threads[workerIndex], 0);
+        }
+        
+        pthread_cond_destroy(&pool->workDone);
+        pthread_cond_destroy(&pool->workReady);
+        pthread_mutex_destroy(&pool->lock);
+#endif
+    }
+#endif
+    
+    if (pool->jobs) { BS842_MEMFREE(pool->jobs); }
+    *pool = {};
+}
+
+BSDEF void BS842_Plotting_Shutdown()
+{
+    BS842_ASSERT(bs842_plIntInfo.initialised);
+    
+    BS842_Internal_StopWorkers();
+    
+    for (int plotIndex = 0; plotIndex < bs842_plIntInfo.plotCount; ++plotIndex)
+    {
+        if (bs842_plIntInfo.plots[plotIndex])
+        {
+            BS842_Plotting_DestroyPlot(plotIndex);
+        }
+    }
+    
+    if (bs842_plIntInfo.plots) { BS842_MEMFREE(bs842_plIntInfo.plots); }
+    BS842_MEMFREE(bs842_plIntInfo.fontBuffer);
+    
+    bs842_plIntInfo = {};
 }
 
 BSDEF void BS842_Plotting_ChangePlotOption(int plotIndex, BS842_PlotOption option, int intVal, float fltVal)
 {
-    BS842_Plot *plot = &bs842_plIntInfo.plots[plotIndex];
-    BS842_ASSERT(bs842_plIntInfo.initialised && plot->enabled);
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
+    plot->dirty = true;
+    
+    // NOTE(bSalmon): The trace options are only read when drawing the data
+    if (option != PlotOpt_Colour1 && option != PlotOpt_Colour2 && option != PlotOpt_Decimation)
+    {
+        plot->staticLayerDirty = true;
+    }
     
     switch (option)
     {
@@ -468,8 +1000,7 @@ BSDEF void BS842_Plotting_ChangePlotOption(int plotIndex, BS842_PlotOption optio
 
 BSDEF void BS842_Plotting_GetPlotOption(void *result, int plotIndex, BS842_PlotOption option)
 {
-    BS842_Plot *plot = &bs842_plIntInfo.plots[plotIndex];
-    BS842_ASSERT(bs842_plIntInfo.initialised && plot->enabled);
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
     
     switch (option)
     {
@@ -495,52 +1026,190 @@ BSDEF void BS842_Plotting_GetPlotOption(void *result, int plotIndex, BS842_PlotO
     
 }
 
+// NOTE(bSalmon): Data sets past the last one asked for are created empty
+BSDEF BS842_DataSet *BS842_Internal_GetDataSet(BS842_Plot *plot, int dataSetIndex)
+{
+    BS842_ASSERT(dataSetIndex >= 0);
+    
+    if (dataSetIndex >= plot->dataSetCapacity)
+    {
+        int newCapacity = plot->dataSetCapacity ? plot->dataSetCapacity * 2 : 4;
+        while (newCapacity <= dataSetIndex)
+        {
+            newCapacity *= 2;
+        }
+        
+        BS842_DataSet *newData = (BS842_DataSet *)BS842_MEMALLOC(newCapacity * sizeof(BS842_DataSet));
+        if (plot->data)
+        {
+            BS842_MEMCOPY(newData, plot->data, plot->dataSetCount * sizeof(BS842_DataSet));
+            BS842_MEMFREE(plot->data);
+        }
+        
+        plot->data = newData;
+        plot->dataSetCapacity = newCapacity;
+    }
+    
+    if (dataSetIndex >= plot->dataSetCount)
+    {
+        plot->dataSetCount = dataSetIndex + 1;
+    }
+    
+    BS842_DataSet *result = &plot->data[dataSetIndex];
+    return result;
+}
+
+// NOTE(bSalmon): Repacks every data set into a new data arena with the one data set at its new capacity, that one is
+// cleared and the rest keep their data, unwrapped so their oldest datum is first
+BSDEF void BS842_Internal_AllocDataSet(BS842_Plot *plot, BS842_DataSet *dataSet, int capacity)
+{
+    size_t dataSize = 0;
+    for (int dataSetIndex = 0; dataSetIndex < plot->dataSetCount; ++dataSetIndex)
+    {
+        BS842_DataSet *currDataSet = &plot->data[dataSetIndex];
+        dataSize += (currDataSet == dataSet ? capacity : currDataSet->capacity) * 2 * sizeof(float);
+    }
+    
+    BS842_Plotting_Internal_Arena newArena = {};
+    BS842_Internal_ReserveArena(&newArena, dataSize);
+    
+    for (int dataSetIndex = 0; dataSetIndex < plot->dataSetCount; ++dataSetIndex)
+    {
+        BS842_DataSet *currDataSet = &plot->data[dataSetIndex];
+        if (currDataSet == dataSet)
+        {
+            currDataSet->xData = (float *)BS842_Internal_PushSize(&newArena, capacity * sizeof(float));
+            currDataSet->yData = (float *)BS842_Internal_PushSize(&newArena, capacity * sizeof(float));
+            currDataSet->capacity = capacity;
+            currDataSet->datumCount = 0;
+            currDataSet->firstDatum = 0;
+        }
+        else if (currDataSet->capacity)
+        {
+            float *xData = (float *)BS842_Internal_PushSize(&newArena, currDataSet->capacity * sizeof(float));
+            float *yData = (float *)BS842_Internal_PushSize(&newArena, currDataSet->capacity * sizeof(float));
+            
+            int tailCount = currDataSet->capacity - currDataSet->firstDatum;
+            if (tailCount > currDataSet->datumCount)
+            {
+                tailCount = currDataSet->datumCount;
+            }
+            
+            BS842_MEMCOPY(xData, currDataSet->xData + currDataSet->firstDatum, tailCount * sizeof(float));
+            BS842_MEMCOPY(yData, currDataSet->yData + currDataSet->firstDatum, tailCount * sizeof(float));
+            BS842_MEMCOPY(xData + tailCount, currDataSet->xData, (currDataSet->datumCount - tailCount) * sizeof(float));
+            BS842_MEMCOPY(yData + tailCount, currDataSet->yData, (currDataSet->datumCount - tailCount) * sizeof(float));
+            
+            currDataSet->xData = xData;
+            currDataSet->yData = yData;
+            currDataSet->firstDatum = 0;
+        }
+    }
+    
+    BS842_Internal_FreeArena(&plot->dataArena);
+    plot->dataArena = newArena;
+}
+
+// NOTE(bSalmon): Replaces the whole series, the storage is only reallocated when it has to grow
 BSDEF void BS842_Plotting_PlotData(int plotIndex, s32 dataSetIndex, float *xData, float *yData, int datumCount)
 {
-    BS842_Plot *plot = &bs842_plIntInfo.plots[plotIndex];
-    BS842_ASSERT(bs842_plIntInfo.initialised && plot->enabled);
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
     
-    if (plot->data[dataSetIndex].xData) { BS842_MEMFREE(plot->data[dataSetIndex].xData); }
-    if (plot->data[dataSetIndex].yData) { BS842_MEMFREE(plot->data[dataSetIndex].yData); }
+    BS842_DataSet *dataSet = BS842_Internal_GetDataSet(plot, dataSetIndex);
+    if (dataSet->capacity < datumCount)
+    {
+        BS842_Internal_AllocDataSet(plot, dataSet, datumCount);
+    }
     
-    plot->data[dataSetIndex].xData = (float *)BS842_MEMALLOC(datumCount * sizeof(float));
-    plot->data[dataSetIndex].yData = (float *)BS842_MEMALLOC(datumCount * sizeof(float));
-    plot->data[dataSetIndex].datumCount = datumCount;
+    dataSet->datumCount = datumCount;
+    dataSet->firstDatum = 0;
+    plot->dirty = true;
     
     float maxValY = ((float *)plot->optionValues)[PlotOpt_MaxValY];
     for (int datumIndex = 0; datumIndex < datumCount; ++datumIndex)
     {
-        plot->data[dataSetIndex].xData[datumIndex] = xData[datumIndex];
-        plot->data[dataSetIndex].yData[datumIndex] = maxValY - yData[datumIndex];
+        dataSet->xData[datumIndex] = xData[datumIndex];
+        dataSet->yData[datumIndex] = maxValY - yData[datumIndex];
     }
 }
 
-BSDEF void BS842_Plotting_UpdatePlot(int plotIndex)
+// NOTE(bSalmon): Sets how many data the ring buffer holds before appends start overwriting the oldest, clears the data set
+BSDEF void BS842_Plotting_SetDataCapacity(int plotIndex, s32 dataSetIndex, int capacity)
 {
-    // TODO(bSalmon): SIMD
-    BS842_Plot *plot = &bs842_plIntInfo.plots[plotIndex];
-    BS842_ASSERT(bs842_plIntInfo.initialised && plot->enabled);
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
+    BS842_ASSERT(capacity > 0);
     
-    int rightEdge = plot->backBuffer.width - 1;
-    int bottomEdge = plot->backBuffer.height - 1;
+    BS842_Internal_AllocDataSet(plot, BS842_Internal_GetDataSet(plot, dataSetIndex), capacity);
+    plot->dirty = true;
+}
+
+// NOTE(bSalmon): Streams data onto the end of the series, once it's full each new datum replaces the oldest one.
+// Never allocates unless the data set has no storage yet, in which case it gets BS842_PLOTTING_DEFAULT_CAPACITY
+BSDEF void BS842_Plotting_AppendData(int plotIndex, s32 dataSetIndex, float *xData, float *yData, int datumCount)
+{
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
+    
+    BS842_DataSet *dataSet = BS842_Internal_GetDataSet(plot, dataSetIndex);
+    if (!dataSet->capacity)
+    {
+        BS842_Internal_AllocDataSet(plot, dataSet, BS842_PLOTTING_DEFAULT_CAPACITY);
+    }
+    
+    plot->dirty = true;
+    
+    float maxValY = ((float *)plot->optionValues)[PlotOpt_MaxValY];
+    for (int datumIndex = 0; datumIndex < datumCount; ++datumIndex)
+    {
+        int writeIndex = dataSet->firstDatum + dataSet->datumCount;
+        if (writeIndex >= dataSet->capacity)
+        {
+            writeIndex -= dataSet->capacity;
+        }
+        
+        dataSet->xData[writeIndex] = xData[datumIndex];
+        dataSet->yData[writeIndex] = maxValY - yData[datumIndex];
+        
+        if (dataSet->datumCount < dataSet->capacity)
+        {
+            ++dataSet->datumCount;
+        }
+        else if (++dataSet->firstDatum == dataSet->capacity)
+        {
+            dataSet->firstDatum = 0;
+        }
+    }
+}
+
+// NOTE(bSalmon): 0 goes back to the default, Colour1 and Colour2 for the first two data sets then a fixed cycle
+BSDEF void BS842_Plotting_SetDataColour(int plotIndex, s32 dataSetIndex, int colour)
+{
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
+    BS842_Internal_GetDataSet(plot, dataSetIndex)->colour = colour;
+    plot->dirty = true;
+}
+
+// NOTE(bSalmon): Margins, borders, grid and axis labels. None of it depends on the data, so it's drawn into its own
+// surface and only redrawn when an option it uses or the plot size changes
+BSDEF void BS842_Internal_DrawStaticLayer(BS842_Plot *plot)
+{
+    int rightEdge = plot->staticLayer.width - 1;
+    int bottomEdge = plot->staticLayer.height - 1;
     
     int borderColour = ((int *)plot->optionValues)[PlotOpt_ColourBorders];
     int backgroundColour = ((int *)plot->optionValues)[PlotOpt_ColourBack];
     int marginColour = ((int *)plot->optionValues)[PlotOpt_ColourMargin];
     int subColour = ((int *)plot->optionValues)[PlotOpt_ColourSub];
     
-    int colour[2] = {((int *)plot->optionValues)[PlotOpt_Colour1], ((int *)plot->optionValues)[PlotOpt_Colour2]};
-    
     int marginLeft = ((int *)plot->optionValues)[PlotOpt_MarginLeft];
     int marginRight = ((int *)plot->optionValues)[PlotOpt_MarginRight];
     int marginTop = ((int *)plot->optionValues)[PlotOpt_MarginTop];
     int marginBottom = ((int *)plot->optionValues)[PlotOpt_MarginBottom];
     
-    unsigned char *row = (unsigned char *)plot->backBuffer.memory;
-    for (int y = 0; y < plot->backBuffer.height; ++y)
+    unsigned char *row = (unsigned char *)plot->staticLayer.memory;
+    for (int y = 0; y < plot->staticLayer.height; ++y)
     {
         int *pixel = (int *)row;
-        for (int x = 0; x < plot->backBuffer.width; ++x)
+        for (int x = 0; x < plot->staticLayer.width; ++x)
         {
             if (x == 0 || y == 0 ||
                 x == rightEdge || y == bottomEdge ||
@@ -563,107 +1232,146 @@ BSDEF void BS842_Plotting_UpdatePlot(int plotIndex)
             
         }
         
-        row += plot->backBuffer.pitch;
+        row += plot->staticLayer.pitch;
         
     }
     
     BS842_Internal_V2I plotMin = {marginLeft + 1, marginTop + 1};
     BS842_Internal_V2I plotMax = {rightEdge - marginRight, bottomEdge - marginBottom};
     
-    float plotHeight = (float)(plotMax.y - plotMin.y);
-    
     BS842_Internal_V2F minVal = {((float *)plot->optionValues)[PlotOpt_MinValX], ((float *)plot->optionValues)[PlotOpt_MinValY]};
     BS842_Internal_V2F maxVal = {((float *)plot->optionValues)[PlotOpt_MaxValX], ((float *)plot->optionValues)[PlotOpt_MaxValY]};
     
     BS842_Internal_V2F minor = {((float *)plot->optionValues)[PlotOpt_MinorX], ((float *)plot->optionValues)[PlotOpt_MinorY]};
     BS842_Internal_V2F major = {((float *)plot->optionValues)[PlotOpt_MajorX], ((float *)plot->optionValues)[PlotOpt_MajorY]};
     
-    BS842_Internal_V2I minorMarksCount = {0, 0};
-    BS842_Internal_V2I majorMarksCount = {0, 0};
+    BS842_Internal_V2I plotSize = {plotMax.x - plotMin.x, plotMax.y - plotMin.y};
     
-    float *minorMarksX = 0;
-    BS842_Internal_GetMarks(&minorMarksCount.x, &minorMarksX, minVal.x, maxVal.x, minor.x);
+    major.x = BS842_Internal_GetTickStep(minVal.x, maxVal.x, major.x, plotSize.x, BS842_PLOTTING_MAJOR_TICK_SPACING);
+    major.y = BS842_Internal_GetTickStep(minVal.y, maxVal.y, major.y, plotSize.y, BS842_PLOTTING_MAJOR_TICK_SPACING);
     
-    float *majorMarksX = 0;
-    BS842_Internal_GetMarks(&majorMarksCount.x, &majorMarksX, minVal.x, maxVal.x, major.x);
+    minor.x = (minor.x > 0.0f) ? minor.x : BS842_Internal_GetMinorStep(major.x);
+    minor.y = (minor.y > 0.0f) ? minor.y : BS842_Internal_GetMinorStep(major.y);
+    minor.x = BS842_Internal_GetTickStep(minVal.x, maxVal.x, minor.x, plotSize.x, BS842_PLOTTING_MINOR_TICK_SPACING);
+    minor.y = BS842_Internal_GetTickStep(minVal.y, maxVal.y, minor.y, plotSize.y, BS842_PLOTTING_MINOR_TICK_SPACING);
     
-    float *minorMarksY = 0;
-    BS842_Internal_GetMarks(&minorMarksCount.y, &minorMarksY, minVal.y, maxVal.y, minor.y);
-    
-    float *majorMarksY = 0;
-    BS842_Internal_GetMarks(&majorMarksCount.y, &majorMarksY, minVal.y, maxVal.y, major.y);
-    
-    for (int y = plotMin.y; y < plotMax.y; ++y)
+    // NOTE(bSalmon): Grid lines go on the plot area only, the tick at each end of the range is the border so only gets a label.
+    // The data are stored flipped in y, so y ticks are made in displayed values and mapped bottom to top
+    float firstTick = 0.0f;
+    int tickCount = BS842_Internal_GetTicks(&firstTick, minVal.y, maxVal.y, minor.y);
+    for (int tickIndex = 0; tickIndex < tickCount; ++tickIndex)
     {
-        for (int minorIndex = 0; minorIndex < minorMarksCount.y; ++minorIndex)
+        int y = BS842_Internal_GetValueInMappedRanges(firstTick + (tickIndex * minor.y), minVal.y, maxVal.y, plotMax.y, plotMin.y);
+        if (y >= plotMin.y && y < plotMax.y)
         {
-            if (BS842_Internal_GetValueInMappedRanges(minorMarksY[minorIndex], minVal.y, maxVal.y, plotMin.y, plotMax.y) == y)
-            {
-                BS842_Internal_DrawDottedHorizontalLine(&plot->backBuffer, plotMin.x, plotMax.x, y, subColour);
-            }
+            BS842_Internal_DrawDottedHorizontalLine(&plot->staticLayer, plotMin.x, plotMax.x, y, subColour);
         }
-        
-        for (int majorIndex = 0; majorIndex < majorMarksCount.y; ++majorIndex)
+    }
+    
+    tickCount = BS842_Internal_GetTicks(&firstTick, minVal.x, maxVal.x, minor.x);
+    for (int tickIndex = 0; tickIndex < tickCount; ++tickIndex)
+    {
+        int x = BS842_Internal_GetValueInMappedRanges(firstTick + (tickIndex * minor.x), minVal.x, maxVal.x, plotMin.x, plotMax.x);
+        if (x >= plotMin.x && x < plotMax.x)
         {
-            if (BS842_Internal_GetValueInMappedRanges(majorMarksY[majorIndex], minVal.y, maxVal.y, plotMin.y, plotMax.y) == y)
-            {
-                BS842_Internal_DrawBresenhamLine(&plot->backBuffer, {plotMin.x, y}, {plotMax.x, y}, plotMin, plotMax, 1.0f, subColour);
-                
-                // TODO(bSalmon): Calc x gap from line using string length
-                float textLineHeight = 13.0f;
-                char majorText[16] = {};
-                sprintf(majorText, "%.01f\0", majorMarksY[(majorMarksCount.y - 1) - majorIndex] + major.y);
-                BS842_Internal_DrawText(&plot->backBuffer, plot->fontInfo, majorText, {plotMin.x - (int)textLineHeight * 2, y},
-                                        textLineHeight, (int)(marginLeft * 0.75f), 0xFF000000);
-            }
+            BS842_Internal_DrawDottedVerticalLine(&plot->staticLayer, plotMin.y, plotMax.y, x, subColour);
         }
     }
     
-    for (int x = plotMin.x; x < plotMax.x; ++x)
+    // TODO(bSalmon): Calc x gap from line using string length
+    float textLineHeight = 13.0f;
+    
+    tickCount = BS842_Internal_GetTicks(&firstTick, minVal.y, maxVal.y, major.y);
+    for (int tickIndex = 0; tickIndex < tickCount; ++tickIndex)
     {
-        for (int minorIndex = 0; minorIndex < minorMarksCount.x; ++minorIndex)
+        float tick = firstTick + (tickIndex * major.y);
+        int y = BS842_Internal_GetValueInMappedRanges(tick, minVal.y, maxVal.y, plotMax.y, plotMin.y);
+        if (y >= plotMin.y && y < plotMax.y)
         {
-            if (BS842_Internal_GetValueInMappedRanges(minorMarksX[minorIndex], minVal.x, maxVal.x, plotMin.x, plotMax.x) == x)
-            {
-                BS842_Internal_DrawDottedVerticalLine(&plot->backBuffer, plotMin.y, plotMax.y, x, subColour);
-            }
+            BS842_Internal_DrawBresenhamLine(&plot->staticLayer, {plotMin.x, y}, {plotMax.x, y}, plotMin, plotMax, 1.0f, subColour);
         }
         
-        for (int majorIndex = 0; majorIndex < majorMarksCount.x; ++majorIndex)
+        char majorText[16] = {};
+        BS842_Internal_FormatTick(majorText, sizeof(majorText), tick, major.y);
+        BS842_Internal_DrawText(&plot->staticLayer, plot->fontInfo, majorText, {plotMin.x - (int)textLineHeight * 2, y},
+                                textLineHeight, (int)(marginLeft * 0.75f), 0xFF000000);
+    }
+    
+    tickCount = BS842_Internal_GetTicks(&firstTick, minVal.x, maxVal.x, major.x);
+    for (int tickIndex = 0; tickIndex < tickCount; ++tickIndex)
+    {
+        float tick = firstTick + (tickIndex * major.x);
+        int x = BS842_Internal_GetValueInMappedRanges(tick, minVal.x, maxVal.x, plotMin.x, plotMax.x);
+        if (x >= plotMin.x && x < plotMax.x)
         {
-            if (BS842_Internal_GetValueInMappedRanges(majorMarksX[majorIndex], minVal.x, maxVal.x, plotMin.x, plotMax.x) == x)
-            {
-                BS842_Internal_DrawBresenhamLine(&plot->backBuffer, {x, plotMin.y}, {x, plotMax.y}, plotMin, plotMax, 1.0f, subColour);
-                
-                float textLineHeight = 13.0f;
-                char majorText[16] = {};
-                sprintf(majorText, "%.01f\0", majorMarksX[majorIndex]);
-                BS842_Internal_DrawText(&plot->backBuffer, plot->fontInfo, majorText, {x, plotMax.y + (int)textLineHeight},
-                                        textLineHeight, (int)(marginLeft * 0.75f), 0xFF000000);
-            }
+            BS842_Internal_DrawBresenhamLine(&plot->staticLayer, {x, plotMin.y}, {x, plotMax.y}, plotMin, plotMax, 1.0f, subColour);
         }
+        
+        char majorText[16] = {};
+        BS842_Internal_FormatTick(majorText, sizeof(majorText), tick, major.x);
+        BS842_Internal_DrawText(&plot->staticLayer, plot->fontInfo, majorText, {x, plotMax.y + (int)textLineHeight},
+                                textLineHeight, (int)(marginLeft * 0.75f), 0xFF000000);
     }
     
-    if (minorMarksX) { BS842_MEMFREE(minorMarksX); }
-    if (majorMarksX) { BS842_MEMFREE(majorMarksX); }
-    if (minorMarksY) { BS842_MEMFREE(minorMarksY); }
-    if (majorMarksY) { BS842_MEMFREE(majorMarksY); }
+    plot->staticLayerDirty = false;
+}
+
+BSDEF void BS842_Plotting_UpdatePlot(int plotIndex)
+{
+    // TODO(bSalmon): SIMD
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
     
-    for (int dataSetIndex = 0; dataSetIndex < BS842_ARRAY_COUNT(plot->data); ++dataSetIndex)
+    if (plot->staticLayerDirty)
     {
-        BS842_Internal_V2I prevMapped = {0, 0};
-        for (int point = 0; point < plot->data[dataSetIndex].datumCount; ++point)
+        BS842_Internal_DrawStaticLayer(plot);
+    }
+    
+    BS842_MEMCOPY(plot->backBuffer.memory, plot->staticLayer.memory, plot->backBuffer.height * plot->backBuffer.pitch);
+    plot->dirty = false;
+    
+    int rightEdge = plot->backBuffer.width - 1;
+    int bottomEdge = plot->backBuffer.height - 1;
+    
+    int marginLeft = ((int *)plot->optionValues)[PlotOpt_MarginLeft];
+    int marginRight = ((int *)plot->optionValues)[PlotOpt_MarginRight];
+    int marginTop = ((int *)plot->optionValues)[PlotOpt_MarginTop];
+    int marginBottom = ((int *)plot->optionValues)[PlotOpt_MarginBottom];
+    
+    BS842_Internal_V2I plotMin = {marginLeft + 1, marginTop + 1};
+    BS842_Internal_V2I plotMax = {rightEdge - marginRight, bottomEdge - marginBottom};
+    
+    BS842_Internal_V2F minVal = {((float *)plot->optionValues)[PlotOpt_MinValX], ((float *)plot->optionValues)[PlotOpt_MinValY]};
+    BS842_Internal_V2F maxVal = {((float *)plot->optionValues)[PlotOpt_MaxValX], ((float *)plot->optionValues)[PlotOpt_MaxValY]};
+    
+    // NOTE(bSalmon): Series that fit in the plot's columns are drawn datum to datum, anything denser is decimated first
+    int decimation = ((int *)plot->optionValues)[PlotOpt_Decimation];
+    int columnCount = (plotMax.x - plotMin.x) + 1;
+    for (int dataSetIndex = 0; dataSetIndex < plot->dataSetCount; ++dataSetIndex)
+    {
+        BS842_DataSet *dataSet = &plot->data[dataSetIndex];
+        
+        int colour = dataSet->colour;
+        if (!colour)
         {
-            BS842_Internal_V2I mapped =
-            {BS842_Internal_GetValueInMappedRanges(plot->data[dataSetIndex].xData[point], minVal.x, maxVal.x, plotMin.x, plotMax.x),
-                BS842_Internal_GetValueInMappedRanges(plot->data[dataSetIndex].yData[point], minVal.y, maxVal.y, plotMin.y, plotMax.y)};
-            
-            if (point > 0)
+            switch (dataSetIndex)
             {
-                BS842_Internal_DrawBresenhamLine(&plot->backBuffer, prevMapped, mapped, plotMin, plotMax, 1.0f, colour[dataSetIndex]);
+                case 0: {colour = ((int *)plot->optionValues)[PlotOpt_Colour1];} break;
+                case 1: {colour = ((int *)plot->optionValues)[PlotOpt_Colour2];} break;
+                default: {colour = (int)bs842_plDataSetColours[(dataSetIndex - 2) % BS842_ARRAY_COUNT(bs842_plDataSetColours)];} break;
             }
-            
-            prevMapped = mapped;
+        }
+        
+        if (decimation == PlotDecimation_MinMax && dataSet->datumCount > columnCount)
+        {
+            BS842_Internal_DrawSeriesMinMax(&plot->backBuffer, dataSet, minVal, maxVal, plotMin, plotMax, colour);
+        }
+        else if (decimation == PlotDecimation_LTTB && dataSet->datumCount > columnCount && columnCount > 2 && columnCount <= plot->decimatedCapacity)
+        {
+            BS842_Internal_DrawSeriesLTTB(&plot->backBuffer, dataSet, minVal, maxVal, plotMin, plotMax, colour, plot->decimated, columnCount);
+        }
+        else
+        {
+            BS842_Internal_DrawSeries(&plot->backBuffer, dataSet, minVal, maxVal, plotMin, plotMax, colour);
         }
     }
     
@@ -693,24 +1401,234 @@ BSDEF void BS842_Plotting_UpdatePlot(int plotIndex)
 #endif
 }
 
-BSDEF void BS842_Plotting_ResizePlot(int plotIndex, int width, int height)
+#ifdef _MSC_VER
+#include <intrin.h>
+BSDEF int BS842_Internal_AtomicFetchIncrement(volatile int *value)
+{
+    return _InterlockedIncrement((volatile long *)value) - 1;
+}
+#else
+BSDEF int BS842_Internal_AtomicFetchIncrement(volatile int *value)
 {
-    BS842_Plot *plot = &bs842_plIntInfo.plots[plotIndex];
-    BS842_ASSERT(bs842_plIntInfo.initialised && plot->enabled);
+    return __atomic_fetch_add(value, 1, __ATOMIC_RELAXED);
+}
+#endif
+
+BSDEF void BS842_Internal_RunJobs(BS842_Plotting_Internal_WorkerPool *pool)
+{
+    for (int jobIndex = BS842_Internal_AtomicFetchIncrement(&pool->nextJob);
+         jobIndex < pool->jobCount;
+         jobIndex = BS842_Internal_AtomicFetchIncrement(&pool->nextJob))
+    {
+        BS842_Plotting_UpdatePlot(pool->jobs[jobIndex]);
+    }
+}
+
+#ifndef BS842_PLOTTING_NO_THREADS
+#ifdef _WIN32
+BSDEF DWORD WINAPI BS842_Internal_PlotWorker(LPVOID param)
+{
+    BS842_Plotting_Internal_WorkerPool *pool = (BS842_Plotting_Internal_WorkerPool *)param;
     
-    BS842_MEMFREE(plot->backBuffer.memory);
+    unsigned int generation = 0;
+    AcquireSRWLockExclusive(&pool->lock);
+    for (;;)
+    {
+        while (!pool->quit && pool->generation == generation)
+        {
+            SleepConditionVariableSRW(&pool->workReady, &pool->lock, INFINITE, 0);
+        }
+        
+        if (pool->quit)
+        {
+            break;
+        }
+        
+        generation = pool->generation;
+        ReleaseSRWLockExclusive(&pool->lock);
+        
+        BS842_Internal_RunJobs(pool);
+        
+        AcquireSRWLockExclusive(&pool->lock);
+        if (--pool->busyWorkers == 0)
+        {
+            WakeConditionVariable(&pool->workDone);
+        }
+    }
+    ReleaseSRWLockExclusive(&pool->lock);
     
-    plot->backBuffer.width = width;
-    plot->backBuffer.height = height;
-    plot->backBuffer.pitch = width * BS842_BPP;
-    plot->backBuffer.memory = BS842_MEMALLOC(plot->backBuffer.height * plot->backBuffer.pitch);
+    return 0;
+}
+#else
+BSDEF void *BS842_Internal_PlotWorker(void *param)
+{
+    BS842_Plotting_Internal_WorkerPool *pool = (BS842_Plotting_Internal_WorkerPool *)param;
+    
+    unsigned int generation = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (!pool->quit && pool->generation == generation)
+        {
+            pthread_cond_wait(&pool->workReady, &pool->lock);
+        }
+        
+        if (pool->quit)
+        {
+            break;
+        }
+        
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+        
+        BS842_Internal_RunJobs(pool);
+        
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busyWorkers == 0)
+        {
+            pthread_cond_signal(&pool->workDone);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    
+    return 0;
+}
+#endif
+
+// NOTE(bSalmon): One worker per core past the caller's, started the first time there's more than one plot to draw.
+// If no thread starts the pool stays empty and UpdateAll draws everything itself
+BSDEF void BS842_Internal_StartWorkers(BS842_Plotting_Internal_WorkerPool *pool)
+{
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    int workerCount = (int)systemInfo.dwNumberOfProcessors - 1;
+#else
+    int workerCount = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+#endif
+    if (workerCount > BS842_PLOTTING_MAX_WORKERS)
+    {
+        workerCount = BS842_PLOTTING_MAX_WORKERS;
+    }
+    
+    pool->running = true;
+    pool->workerCount = 0;
+    
+#ifdef _WIN32
+    InitializeSRWLock(&pool->lock);
+    InitializeConditionVariable(&pool->workReady);
+    InitializeConditionVariable(&pool->workDone);
+    for (int workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+    {
+        HANDLE thread = CreateThread(0, 0, BS842_Internal_PlotWorker, pool, 0, 0);
+        if (!thread)
+        {
+            break;
+        }
+        pool->threads[pool->workerCount++] = thread;
+    }
+#else
+    pthread_mutex_init(&pool->lock, 0);
+    pthread_cond_init(&pool->workReady, 0);
+    pthread_cond_init(&pool->workDone, 0);
+    for (int workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+    {
+        if (pthread_create(&pool->threads[pool->workerCount], 0, BS842_Internal_PlotWorker, pool) != 0)
+        {
+            break;
+        }
+        ++pool->workerCount;
+    }
+#endif
+}
+#endif
+
+// NOTE(bSalmon): Redraws every plot that's changed since it was last drawn, spread over the worker threads. Each plot
+// only touches its own memory and the shared font while drawing, so nothing is locked per plot, but no plot or data may be
+// changed from another thread until this returns
+BSDEF void BS842_Plotting_UpdateAll()
+{
+    BS842_ASSERT(bs842_plIntInfo.initialised);
+    BS842_Plotting_Internal_WorkerPool *pool = &bs842_plWorkerPool;
+    
+    if (pool->jobCapacity < bs842_plIntInfo.plotCount)
+    {
+        if (pool->jobs) { BS842_MEMFREE(pool->jobs); }
+        pool->jobs = (int *)BS842_MEMALLOC(bs842_plIntInfo.plotCapacity * sizeof(int));
+        pool->jobCapacity = bs842_plIntInfo.plotCapacity;
+    }
+    
+    pool->jobCount = 0;
+    for (int plotIndex = 0; plotIndex < bs842_plIntInfo.plotCount; ++plotIndex)
+    {
+        BS842_Plot *plot = bs842_plIntInfo.plots[plotIndex];
+        if (plot && plot->enabled && plot->dirty)
+        {
+            pool->jobs[pool->jobCount++] = plotIndex;
+        }
+    }
+    pool->nextJob = 0;
+    
+#ifndef BS842_PLOTTING_NO_THREADS
+    if (pool->jobCount > 1)
+    {
+        if (!pool->running)
+        {
+            BS842_Internal_StartWorkers(pool);
+        }
+        
+        if (pool->workerCount)
+        {
+#ifdef _WIN32
+            AcquireSRWLockExclusive(&pool->lock);
+            pool->busyWorkers = pool->workerCount;
+            ++pool->generation;
+            WakeAllConditionVariable(&pool->workReady);
+            ReleaseSRWLockExclusive(&pool->lock);
+            
+            BS842_Internal_RunJobs(pool);
+            
+            AcquireSRWLockExclusive(&pool->lock);
+            while (pool->busyWorkers)
+            {
+                SleepConditionVariableSRW(&pool->workDone, &pool->lock, INFINITE, 0);
+            }
+            ReleaseSRWLockExclusive(&pool->lock);
+#else
+            pthread_mutex_lock(&pool->lock);
+            pool->busyWorkers = pool->workerCount;
+            ++pool->generation;
+            pthread_cond_broadcast(&pool->workReady);
+            pthread_mutex_unlock(&pool->lock);
+            
+            BS842_Internal_RunJobs(pool);
+            
+            pthread_mutex_lock(&pool->lock);
+            while (pool->busyWorkers)
+            {
+                pthread_cond_wait(&pool->workDone, &pool->lock);
+            }
+            pthread_mutex_unlock(&pool->lock);
+#endif
+            return;
+        }
+    }
+#endif
+    
+    BS842_Internal_RunJobs(pool);
+}
+
+BSDEF void BS842_Plotting_ResizePlot(int plotIndex, int width, int height)
+{
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
+    
+    BS842_Internal_AllocSurfaces(plot, width, height);
 }
 
 BSDEF void BS842_Plotting_GetPlotMemory(int plotIndex, void *destMem, int destPitch)
 {
     // TODO(bSalmon): SIMD
-    BS842_Plot *plot = &bs842_plIntInfo.plots[plotIndex];
-    BS842_ASSERT(bs842_plIntInfo.initialised && plot->enabled);
+    BS842_Plot *plot = BS842_Internal_GetPlot(plotIndex);
     
     unsigned char *srcRow = (unsigned char *)plot->backBuffer.memory;
     unsigned char *destRow = (unsigned char *)destMem;
@@ -70,7 +70,8 @@ INTERNAL_ASSERT(backBuffer->memory);
 
 //////////////////
 
-bsint_function void BS842_CreateTextBitmap(unsigned char *result, stbtt_fontinfo *fontInfo, char *text, bsint_f32 lineHeight, bsint_s32 textSizeX, bsint_f32 *charX)
+// NOTE(bSalmon): textLength of -1 means text is null terminated
+bsint_function void BS842_CreateTextBitmap(unsigned char *result, stbtt_fontinfo *fontInfo, const char *text, bsint_s32 textLength, bsint_f32 lineHeight, bsint_s32 textSizeX, bsint_f32 *charX)
 {
     bsint_f32 scale = stbtt_ScaleForPixelHeight(fontInfo, lineHeight);
     
@@ -79,7 +80,7 @@ bsint_function void BS842_CreateTextBitmap(unsigned char *result, stbtt_fontinfo
     baseline = (bsint_s32)(ascent * scale);
     
     bsint_s32 ch = 0;
-    while (text[ch])
+    while (((textLength < 0) || (ch < textLength)) && text[ch])
     {
         bsint_s32 advanceX, leftSideBearing;
         stbtt_GetCodepointHMetrics(fontInfo, text[ch], &advanceX, &leftSideBearing);
@@ -95,7 +96,7 @@ bsint_function void BS842_CreateTextBitmap(unsigned char *result, stbtt_fontinfo
                                           chXMax - chXMin, chYMax - chYMin, textSizeX, scale, scale, xShift, 0, text[ch]);
         
         *charX += (advanceX * scale);
-        if (text[ch + 1])
+        if (((textLength < 0) || ((ch + 1) < textLength)) && text[ch + 1])
         {
             *charX += scale * stbtt_GetCodepointKernAdvance(fontInfo, text[ch], text[ch + 1]);
         }
@@ -104,6 +105,11 @@ bsint_function void BS842_CreateTextBitmap(unsigned char *result, stbtt_fontinfo
     }
 }
 
+bsint_function void BS842_CreateTextBitmap(unsigned char *result, stbtt_fontinfo *fontInfo, char *text, bsint_f32 lineHeight, bsint_s32 textSizeX, bsint_f32 *charX)
+{
+    BS842_CreateTextBitmap(result, fontInfo, text, -1, lineHeight, textSizeX, charX);
+}
+
 bsint_function void BS842_DrawTextBitmap(void *buffer, unsigned char *textBitmap, bsint_u32 colour, bsint_f32 charX, bsint_f32 xPosPercent, bsint_f32 yPosPercent, bsint_s32 textSizeX, bsint_s32 textSizeY, bsint_b32 topLeftAlign = false, bsint_b32 invertDraw = false)
 {
     Text_BackBuffer *backBuffer = (Text_BackBuffer *)buffer;
@@ -256,5 +262,224 @@ bsint_function void BS842_DrawBasicTextElement(void *buffer, stbtt_fontinfo *fon
     free(headBitmap);
 }
 
+// NOTE(bSalmon): Text Batching
+// Items are rasterised into a shared coverage buffer as they are pushed, then BS842_TextBatchFlush sorts them by their top row
+// and composites every item in a single top to bottom sweep of the destination rows. The batch keeps its memory between flushes.
+struct BS842_TextBatchItem
+{
+    bsint_u32 colour;
+    bsint_s32 xPos;
+    bsint_s32 yPos;
+    bsint_s32 width;
+    bsint_s32 height;
+    bsint_mem_index coverageOffset;
+};
+
+struct BS842_TextBatch
+{
+    BS842_TextBatchItem *items;
+    bsint_s32 *order;
+    bsint_s32 itemCount;
+    bsint_s32 itemCapacity;
+    
+    unsigned char *coverage;
+    bsint_mem_index coverageUsed;
+    bsint_mem_index coverageCapacity;
+};
+
+bsint_function bsint_f32 BS842_MeasureText(stbtt_fontinfo *fontInfo, const char *text, bsint_s32 textLength, bsint_f32 lineHeight, bsint_s32 *extentX = 0)
+{
+    bsint_f32 scale = stbtt_ScaleForPixelHeight(fontInfo, lineHeight);
+    
+    bsint_f32 charX = 0.0f;
+    bsint_s32 maxX = 0;
+    bsint_s32 ch = 0;
+    while (((textLength < 0) || (ch < textLength)) && text[ch])
+    {
+        bsint_s32 advanceX, leftSideBearing;
+        stbtt_GetCodepointHMetrics(fontInfo, text[ch], &advanceX, &leftSideBearing);
+        
+        bsint_s32 chXMin, chXMax, chYMin, chYMax;
+        bsint_f32 xShift = charX - (bsint_s32)charX;
+        stbtt_GetCodepointBitmapBoxSubpixel(fontInfo, text[ch], scale, scale, xShift, 0, &chXMin, &chYMin, &chXMax, &chYMax);
+        
+        bsint_s32 right = (bsint_s32)charX + (bsint_s32)(leftSideBearing * scale) + (chXMax - chXMin);
+        maxX = (right > maxX) ? right : maxX;
+        
+        charX += (advanceX * scale);
+        if (((textLength < 0) || ((ch + 1) < textLength)) && text[ch + 1])
+        {
+            charX += scale * stbtt_GetCodepointKernAdvance(fontInfo, text[ch], text[ch + 1]);
+        }
+        
+        ++ch;
+    }
+    
+    if (extentX)
+    {
+        *extentX = ((bsint_s32)charX + 1 > maxX) ? (bsint_s32)charX + 1 : maxX;
+    }
+    
+    return charX;
+}
+
+bsint_function void BS842_TextBatchPush(BS842_TextBatch *batch, void *buffer, stbtt_fontinfo *fontInfo, const char *text, bsint_s32 textLength, bsint_f32 lineHeight, bsint_u32 colour, bsint_f32 xPosPercent, bsint_f32 yPosPercent, bsint_b32 topLeftAlign = false)
+{
+    Text_BackBuffer *backBuffer = (Text_BackBuffer *)buffer;
+    CHECK_TEXT_BACKBUFFER(backBuffer);
+    
+    bsint_s32 textSizeX = 0;
+    bsint_f32 measuredX = BS842_MeasureText(fontInfo, text, textLength, lineHeight, &textSizeX);
+    
+    // NOTE(bSalmon): Leave room for descenders below lineHeight
+    bsint_s32 textSizeY = (bsint_s32)(lineHeight * 1.25f) + 1;
+    if ((textSizeX <= 0) || (lineHeight < 1.0f))
+    {
+        return;
+    }
+    
+    if (batch->itemCount == batch->itemCapacity)
+    {
+        batch->itemCapacity = (batch->itemCapacity) ? batch->itemCapacity * 2 : 64;
+        batch->items = (BS842_TextBatchItem *)realloc(batch->items, batch->itemCapacity * sizeof(BS842_TextBatchItem));
+        batch->order = (bsint_s32 *)realloc(batch->order, batch->itemCapacity * sizeof(bsint_s32));
+    }
+    
+    bsint_mem_index coverageSize = (bsint_mem_index)textSizeX * textSizeY;
+    if (batch->coverageUsed + coverageSize > batch->coverageCapacity)
+    {
+        bsint_mem_index newCapacity = (batch->coverageCapacity) ? batch->coverageCapacity * 2 : 64 * 1024;
+        while (batch->coverageUsed + coverageSize > newCapacity)
+        {
+            newCapacity *= 2;
+        }
+        
+        batch->coverage = (unsigned char *)realloc(batch->coverage, newCapacity);
+        batch->coverageCapacity = newCapacity;
+    }
+    
+    BS842_TextBatchItem *item = &batch->items[batch->itemCount];
+    item->colour = colour;
+    item->width = textSizeX;
+    item->height = textSizeY;
+    item->coverageOffset = batch->coverageUsed;
+    
+    if (topLeftAlign)
+    {
+        item->xPos = bs842_text_internal_RoundF32ToS32(backBuffer->width * xPosPercent);
+        item->yPos = bs842_text_internal_RoundF32ToS32(backBuffer->height * yPosPercent);
+    }
+    else
+    {
+        item->xPos = bs842_text_internal_RoundF32ToS32(backBuffer->width * xPosPercent) - ((bsint_s32)measuredX / 2);
+        item->yPos = bs842_text_internal_RoundF32ToS32(backBuffer->height * yPosPercent) - ((bsint_s32)lineHeight / 2);
+    }
+    
+    unsigned char *coverage = batch->coverage + item->coverageOffset;
+    bs842_internal_ZeroMem(coverage, coverageSize);
+    bsint_f32 charX = 0.0f;
+    BS842_CreateTextBitmap(coverage, fontInfo, text, textLength, lineHeight, textSizeX, &charX);
+    
+    batch->coverageUsed += coverageSize;
+    batch->order[batch->itemCount] = batch->itemCount;
+    ++batch->itemCount;
+}
+
+bsint_function void BS842_TextBatchFlush(void *buffer, BS842_TextBatch *batch)
+{
+    Text_BackBuffer *backBuffer = (Text_BackBuffer *)buffer;
+    CHECK_TEXT_BACKBUFFER(backBuffer);
+    
+    // NOTE(bSalmon): Items usually arrive close to top to bottom so insertion sort is near linear here
+    for (bsint_s32 i = 1; i < batch->itemCount; ++i)
+    {
+        bsint_s32 index = batch->order[i];
+        bsint_s32 j = i - 1;
+        while ((j >= 0) && (batch->items[batch->order[j]].yPos > batch->items[index].yPos))
+        {
+            batch->order[j + 1] = batch->order[j];
+            --j;
+        }
+        batch->order[j + 1] = index;
+    }
+    
+    if (batch->itemCount > 0)
+    {
+        // NOTE(bSalmon): Items overlapping the current row are kept at the front of order[], compacted as they finish
+        bsint_s32 nextItem = 0;
+        bsint_s32 activeCount = 0;
+        bsint_s32 y = batch->items[batch->order[0]].yPos;
+        y = (y < 0) ? 0 : y;
+        
+        bsint_u8 *row = (bsint_u8 *)backBuffer->memory + (y * backBuffer->pitch);
+        for (; (y < backBuffer->height) && ((activeCount > 0) || (nextItem < batch->itemCount)); ++y, row += backBuffer->pitch)
+        {
+            while ((nextItem < batch->itemCount) && (batch->items[batch->order[nextItem]].yPos <= y))
+            {
+                batch->order[activeCount++] = batch->order[nextItem++];
+            }
+            
+            bsint_s32 stillActive = 0;
+            for (bsint_s32 activeIndex = 0; activeIndex < activeCount; ++activeIndex)
+            {
+                BS842_TextBatchItem *item = &batch->items[batch->order[activeIndex]];
+                if (y >= item->yPos + item->height)
+                {
+                    continue;
+                }
+                batch->order[stillActive++] = batch->order[activeIndex];
+                
+                bsint_s32 minX = (item->xPos < 0) ? 0 : item->xPos;
+                bsint_s32 maxX = item->xPos + item->width;
+                maxX = (maxX > backBuffer->width) ? backBuffer->width : maxX;
+                
+                bsint_u8 colourR = (item->colour >> 16) & 0xFF;
+                bsint_u8 colourG = (item->colour >> 8) & 0xFF;
+                bsint_u8 colourB = item->colour & 0xFF;
+                
+                unsigned char *coverage = batch->coverage + item->coverageOffset + ((y - item->yPos) * item->width) - item->xPos;
+                bsint_u32 *pixel = (bsint_u32 *)row;
+                for (bsint_s32 x = minX; x < maxX; ++x)
+                {
+                    bsint_u32 alpha = coverage[x];
+                    if (alpha)
+                    {
+                        bsint_u32 pixelR = (pixel[x] >> 16) & 0xFF;
+                        bsint_u32 pixelG = (pixel[x] >> 8) & 0xFF;
+                        bsint_u32 pixelB = pixel[x] & 0xFF;
+                        
+                        bsint_u32 newR = (pixelR * (255 - alpha) + colourR * alpha) / 255;
+                        bsint_u32 newG = (pixelG * (255 - alpha) + colourG * alpha) / 255;
+                        bsint_u32 newB = (pixelB * (255 - alpha) + colourB * alpha) / 255;
+                        
+                        pixel[x] = (0xFF << 24) | (newR << 16) | (newG << 8) | newB;
+                    }
+                }
+            }
+            activeCount = stillActive;
+            
+            // NOTE(bSalmon): Jump straight to the next item if nothing overlaps the rows in between
+            if ((activeCount == 0) && (nextItem < batch->itemCount) && (batch->items[batch->order[nextItem]].yPos > y + 1))
+            {
+                bsint_s32 nextY = batch->items[batch->order[nextItem]].yPos;
+                row += (nextY - (y + 1)) * backBuffer->pitch;
+                y = nextY - 1;
+            }
+        }
+    }
+    
+    batch->itemCount = 0;
+    batch->coverageUsed = 0;
+}
+
+bsint_function void BS842_TextBatchFree(BS842_TextBatch *batch)
+{
+    free(batch->items);
+    free(batch->order);
+    free(batch->coverage);
+    
+    *batch = {};
+}
+
 #define BS842_TEXT_H
 #endif // BS842_TEXT_H
\ No newline at end of file